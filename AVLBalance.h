@@ -0,0 +1,190 @@
+#ifndef AVLBALANCE_H
+#define AVLBALANCE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+
+// Build with AVL_TREE_STATS defined to count what the tree does internally. Without it the
+// counting statements are not compiled and the tree carries no counter member. Nothing is
+// counted during constant evaluation.
+#ifdef AVL_TREE_STATS
+#define AVL_COUNT(expr) do { if !consteval { expr; } } while (false)
+#else
+#define AVL_COUNT(expr) ((void)0)
+#endif
+
+// Build with AVL_TREE_TRACING defined to record begin/end events of insert, remove, search,
+// rebalancing and rotations into per-thread rings (see AVLTrace.h). Without it no tracing code
+// is generated.
+#ifdef AVL_TREE_TRACING
+#include "AVLTrace.h"
+#define AVL_TRACE_SCOPE(event) const AVLTraceScope avlTraceScope(AVLTraceEvent::event)
+#else
+#define AVL_TRACE_SCOPE(event) ((void)0)
+#endif
+
+struct AVLOperationCounters {
+    std::uint64_t searches = 0;
+    std::uint64_t searchComparisons = 0;
+    std::uint64_t updateComparisons = 0;
+    std::uint64_t singleRotations = 0;
+    std::uint64_t doubleRotations = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+    // Retracing: how many levels above the modified node changed height or rotated.
+    std::uint64_t updates = 0;
+    std::uint64_t retraceSteps = 0;
+    std::uint64_t maxRetraceDepth = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const AVLOperationCounters& c) {
+    const auto ratio = [](const std::uint64_t a, const std::uint64_t b) {
+        return b ? static_cast<double>(a) / static_cast<double>(b) : 0.0;
+    };
+    return os << "searches=" << c.searches
+              << " comparisons_per_search=" << ratio(c.searchComparisons, c.searches)
+              << " update_comparisons=" << c.updateComparisons
+              << " single_rotations=" << c.singleRotations
+              << " double_rotations=" << c.doubleRotations
+              << " allocations=" << c.allocations
+              << " frees=" << c.frees
+              << " updates=" << c.updates
+              << " avg_retrace_depth=" << ratio(c.retraceSteps, c.updates)
+              << " max_retrace_depth=" << c.maxRetraceDepth;
+}
+
+// Height bookkeeping, rotations and rebalancing shared by the AVL trees in this repo, written
+// once against an abstract link. A link is anything that converts to false when empty and can
+// be moved: std::unique_ptr<Node> in AVLTree, an array index with 0 as null in StaticAVLTree.
+// Derived supplies nodeAt(link), returning the node with left, right and height members, and
+// names this base a friend when nodeAt is private. Operation counters live here as well so every
+// tree reports them the same way.
+template <typename Derived>
+class AVLBalance {
+    [[nodiscard]] constexpr Derived& self() { return static_cast<Derived&>(*this); }
+
+    [[nodiscard]] constexpr const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+protected:
+#ifdef AVL_TREE_STATS
+    mutable AVLOperationCounters counters;
+    std::uint64_t retraceDepth = 0;
+
+    // Lookups are const and may run on several threads over one shared tree, so they add to the
+    // counters with relaxed atomics instead.
+    static void countShared(std::uint64_t& counter, const std::uint64_t n) {
+        std::atomic_ref(counter).fetch_add(n, std::memory_order_relaxed);
+    }
+
+    constexpr void finishUpdate() {
+        ++counters.updates;
+        counters.retraceSteps += retraceDepth;
+        counters.maxRetraceDepth = std::max(counters.maxRetraceDepth, retraceDepth);
+        retraceDepth = 0;
+    }
+#endif
+
+    template <typename Link>
+    [[nodiscard]] constexpr int height(const Link& link) const {
+        return link ? self().nodeAt(link).height : 0;
+    }
+
+    template <typename Link>
+    [[nodiscard]] constexpr int balanceFactor(const Link& link) const {
+        if (!link) return 0;
+        const auto& node = self().nodeAt(link);
+        return height(node.left) - height(node.right);
+    }
+
+    template <typename Link>
+    constexpr void updateHeight(const Link& link) {
+        auto& node = self().nodeAt(link);
+        node.height = 1 + std::max(height(node.left), height(node.right));
+    }
+
+    template <typename Link>
+    constexpr Link rotateRight(Link y) {
+        AVL_TRACE_SCOPE(RotateRight);
+        Link x = std::exchange(self().nodeAt(y).left, Link{});
+        self().nodeAt(y).left = std::exchange(self().nodeAt(x).right, Link{});
+
+        updateHeight(y);
+        self().nodeAt(x).right = std::move(y);
+        updateHeight(x);
+
+        return x;
+    }
+
+    template <typename Link>
+    constexpr Link rotateLeft(Link x) {
+        AVL_TRACE_SCOPE(RotateLeft);
+        Link y = std::exchange(self().nodeAt(x).right, Link{});
+        self().nodeAt(x).right = std::exchange(self().nodeAt(y).left, Link{});
+
+        updateHeight(x);
+        self().nodeAt(y).left = std::move(x);
+        updateHeight(y);
+
+        return y;
+    }
+
+    template <typename Link>
+    constexpr Link balance(Link link) {
+        if (!link) return link;
+
+        AVL_TRACE_SCOPE(Balance);
+        auto& node = self().nodeAt(link);
+#ifdef AVL_TREE_STATS
+        const int oldHeight = node.height;
+#endif
+        updateHeight(link);
+        const int bf = balanceFactor(link);
+
+        if (bf > 1) {
+            AVL_COUNT(++retraceDepth);
+            if (balanceFactor(node.left) < 0) {
+                AVL_COUNT(++counters.doubleRotations);
+                node.left = rotateLeft(std::move(node.left));
+            } else {
+                AVL_COUNT(++counters.singleRotations);
+            }
+            return rotateRight(std::move(link));
+        }
+
+        if (bf < -1) {
+            AVL_COUNT(++retraceDepth);
+            if (balanceFactor(node.right) > 0) {
+                AVL_COUNT(++counters.doubleRotations);
+                node.right = rotateRight(std::move(node.right));
+            } else {
+                AVL_COUNT(++counters.singleRotations);
+            }
+            return rotateLeft(std::move(link));
+        }
+
+        AVL_COUNT(retraceDepth += node.height != oldHeight);
+
+        return link;
+    }
+
+public:
+#ifdef AVL_TREE_STATS
+    static constexpr bool countersEnabled = true;
+
+    [[nodiscard]] constexpr const AVLOperationCounters& operationCounters() const { return counters; }
+
+    constexpr void resetCounters() { counters = {}; }
+#else
+    static constexpr bool countersEnabled = false;
+
+    // Always zero, build with AVL_TREE_STATS to collect counters.
+    [[nodiscard]] constexpr AVLOperationCounters operationCounters() const { return {}; }
+
+    constexpr void resetCounters() {}
+#endif
+};
+
+#endif //AVLBALANCE_H
@@ -0,0 +1,57 @@
+#ifndef AVLKEYPREFIX_H
+#define AVLKEYPREFIX_H
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// The first eight bytes of a string key as a big-endian integer, zero padded. AVLTree keeps one
+// in every node next to the value and computes one per searched key. Integer order on prefixes
+// matches the byte order std::string compares by, so two different prefixes decide a
+// comparison without touching the string's heap buffer; only equal prefixes fall back to comparing
+// the remaining bytes. For every other key type the prefix is empty and takes no space in the node.
+template <typename T>
+struct AVLKeyPrefix {
+    static constexpr bool enabled = false;
+
+    constexpr explicit AVLKeyPrefix(const T&) {}
+};
+
+template <typename T>
+    requires std::same_as<T, std::string> || std::same_as<T, std::string_view>
+struct AVLKeyPrefix<T> {
+    static constexpr bool enabled = true;
+
+    std::uint64_t bits = 0;
+
+    constexpr explicit AVLKeyPrefix(const T& key) {
+        const std::string_view bytes(key);
+        if !consteval {
+            if (bytes.size() >= sizeof(bits)) {
+                std::memcpy(&bits, bytes.data(), sizeof(bits));
+                if constexpr (std::endian::native == std::endian::little) bits = std::byteswap(bits);
+                return;
+            }
+        }
+        for (std::size_t i = 0; i < sizeof(bits); ++i) {
+            bits = bits << 8 | (i < bytes.size() ? static_cast<unsigned char>(bytes[i]) : 0u);
+        }
+    }
+
+    // Three-way compare of two keys whose prefixes are equal. When both are at least eight bytes
+    // long those bytes are known to match and are skipped; shorter keys may differ only in
+    // length or in embedded zero bytes, so they are compared in full.
+    [[nodiscard]] static constexpr int compareTail(const T& a, const T& b) {
+        std::string_view left(a);
+        std::string_view right(b);
+        if (left.size() >= sizeof(bits) && right.size() >= sizeof(bits)) {
+            left.remove_prefix(sizeof(bits));
+            right.remove_prefix(sizeof(bits));
+        }
+        return left.compare(right);
+    }
+};
+
+#endif //AVLKEYPREFIX_H
@@ -0,0 +1,17 @@
+#ifndef AVLPARALLELCLONE_H
+#define AVLPARALLELCLONE_H
+
+#include <cstddef>
+#include <future>
+#include <utility>
+
+#include "AVLTree.h"
+
+// AVLTree::clone(threads, spawn) with one std::async thread per task. In its own header so that
+// only callers include <future> and its threading headers.
+template <Comparable T>
+[[nodiscard]] AVLTree<T> parallelClone(const AVLTree<T>& tree, const std::size_t threads) {
+    return tree.clone(threads, [](auto task) { return std::async(std::launch::async, std::move(task)); });
+}
+
+#endif //AVLPARALLELCLONE_H
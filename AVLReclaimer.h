@@ -0,0 +1,124 @@
+#ifndef AVLRECLAIMER_H
+#define AVLRECLAIMER_H
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// Memory that can be freed a bounded amount at a time.
+class AVLGarbage {
+public:
+    virtual ~AVLGarbage() = default;
+
+    // Frees up to budget nodes; returns true once nothing is left.
+    virtual bool reclaim(std::size_t budget) = 0;
+};
+
+// Garbage with a non-virtual reclaim(), such as the nodes AVLTree::clear() hands over.
+template <typename Garbage>
+concept AVLReclaimable = requires(Garbage& garbage, std::size_t budget) {
+    { garbage.reclaim(budget) } -> std::same_as<bool>;
+};
+
+// Background thread that frees retired trees in batches of batchSize nodes, pausing between
+// batches so it does not compete with the application for the allocator or a core. Retiring
+// takes a lock and appends to a queue, so tearing down a tree costs the caller O(1). The
+// destructor frees whatever is still queued, without pauses, and joins the thread.
+class AVLReclaimer {
+public:
+    struct Options {
+        std::size_t batchSize = 4096;
+        std::chrono::microseconds pause{100};
+    };
+
+private:
+    Options options;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<std::unique_ptr<AVLGarbage>> queue;
+    bool busy = false;
+    std::atomic<bool> stopping = false;
+    std::thread worker;
+
+    template <AVLReclaimable Garbage>
+    struct Wrapped final : AVLGarbage {
+        Garbage garbage;
+
+        explicit Wrapped(Garbage&& garbage) : garbage(std::move(garbage)) {}
+
+        bool reclaim(const std::size_t budget) override { return garbage.reclaim(budget); }
+    };
+
+    void run() {
+        std::unique_lock lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+
+            std::unique_ptr<AVLGarbage> garbage = std::move(queue.front());
+            queue.pop_front();
+            busy = true;
+            lock.unlock();
+
+            while (!garbage->reclaim(options.batchSize)) {
+                if (!stopping) std::this_thread::sleep_for(options.pause);
+            }
+            garbage.reset();
+
+            lock.lock();
+            busy = false;
+            if (queue.empty()) idle.notify_all();
+        }
+    }
+
+public:
+    AVLReclaimer() : AVLReclaimer(Options{}) {}
+
+    explicit AVLReclaimer(const Options options) : options(options), worker([this] { run(); }) {}
+
+    AVLReclaimer(const AVLReclaimer&) = delete;
+    AVLReclaimer& operator=(const AVLReclaimer&) = delete;
+
+    ~AVLReclaimer() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    void retire(std::unique_ptr<AVLGarbage> garbage) {
+        {
+            std::lock_guard lock(mutex);
+            queue.push_back(std::move(garbage));
+        }
+        wake.notify_one();
+    }
+
+    template <AVLReclaimable Garbage>
+    void retire(Garbage garbage) {
+        retire(std::make_unique<Wrapped<Garbage>>(std::move(garbage)));
+    }
+
+    // Blocks until everything retired so far has been freed.
+    void drain() {
+        std::unique_lock lock(mutex);
+        idle.wait(lock, [this] { return queue.empty() && !busy; });
+    }
+
+    [[nodiscard]] std::size_t pending() {
+        std::lock_guard lock(mutex);
+        return queue.size() + busy;
+    }
+};
+
+#endif //AVLRECLAIMER_H
@@ -0,0 +1,145 @@
+#ifndef AVLTRACE_H
+#define AVLTRACE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Begin/end events of AVLTree's hot paths, recorded into one ring buffer per thread. AVLTree
+// only includes this header and emits events when AVL_TREE_TRACING is defined; otherwise
+// AVL_TRACE_SCOPE expands to nothing.
+
+#ifndef AVL_TRACE_RING_CAPACITY
+#define AVL_TRACE_RING_CAPACITY (1u << 16)
+#endif
+
+enum class AVLTraceEvent : std::uint8_t { Insert, Remove, Search, Balance, RotateLeft, RotateRight };
+
+inline constexpr std::array<const char*, 6> avlTraceEventNames{
+    "insert", "remove", "search", "balance", "rotateLeft", "rotateRight"};
+
+// Single producer: only the owning thread pushes. Readers copy a window and then re-read the
+// head to drop the slots the producer may have overwritten meanwhile, so a dump never blocks
+// the traced thread. Once full, the oldest events are overwritten.
+class AVLTraceRing {
+public:
+    static constexpr std::size_t capacity = AVL_TRACE_RING_CAPACITY;
+    static_assert((capacity & (capacity - 1)) == 0, "trace ring capacity must be a power of two");
+
+    struct Event {
+        std::uint64_t timestampNs;
+        AVLTraceEvent event;
+        bool begin;
+    };
+
+    void push(const AVLTraceEvent event, const bool begin) {
+        const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        const std::uint64_t index = head.load(std::memory_order_relaxed);
+        Slot& slot = slots[index & (capacity - 1)];
+        slot.timestampNs.store(static_cast<std::uint64_t>(now), std::memory_order_relaxed);
+        slot.tag.store(static_cast<std::uint8_t>(event) << 1 | static_cast<std::uint8_t>(begin), std::memory_order_relaxed);
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    [[nodiscard]] std::vector<Event> snapshot() const {
+        const std::uint64_t end = head.load(std::memory_order_acquire);
+        const std::uint64_t begin = end > capacity ? end - capacity : 0;
+
+        std::vector<Event> events;
+        events.reserve(end - begin);
+        for (std::uint64_t i = begin; i < end; ++i) {
+            const Slot& slot = slots[i & (capacity - 1)];
+            const std::uint8_t tag = slot.tag.load(std::memory_order_relaxed);
+            events.push_back({slot.timestampNs.load(std::memory_order_relaxed), static_cast<AVLTraceEvent>(tag >> 1),
+                              static_cast<bool>(tag & 1)});
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t after = head.load(std::memory_order_relaxed);
+        const std::uint64_t firstValid = after >= capacity ? after - capacity + 1 : 0;
+        if (firstValid > begin) {
+            events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(std::min(firstValid - begin, end - begin)));
+        }
+        return events;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> timestampNs{0};
+        std::atomic<std::uint8_t> tag{0};
+    };
+
+    std::array<Slot, capacity> slots{};
+    std::atomic<std::uint64_t> head{0};
+};
+
+// Rings are registered on a thread's first event and live until process exit, so the events
+// of threads that already finished can still be dumped.
+class AVLTraceRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<AVLTraceRing>> rings;
+
+public:
+    static AVLTraceRegistry& instance() {
+        static AVLTraceRegistry registry;
+        return registry;
+    }
+
+    AVLTraceRing& local() {
+        thread_local AVLTraceRing* ring = [this] {
+            std::lock_guard lock(mutex);
+            rings.push_back(std::make_unique<AVLTraceRing>());
+            return rings.back().get();
+        }();
+        return *ring;
+    }
+
+    // Chrome trace event format, loadable in chrome://tracing and Perfetto. Threads appear in
+    // the order they first emitted an event.
+    void writeChromeTrace(std::ostream& os) {
+        std::lock_guard lock(mutex);
+        os << "{\"traceEvents\":[";
+        bool first = true;
+        for (std::size_t tid = 0; tid < rings.size(); ++tid) {
+            for (const AVLTraceRing::Event& e : rings[tid]->snapshot()) {
+                os << (first ? "\n" : ",\n") << "{\"name\":\"" << avlTraceEventNames[static_cast<std::size_t>(e.event)]
+                   << "\",\"ph\":\"" << (e.begin ? 'B' : 'E') << "\",\"ts\":" << e.timestampNs / 1000 << '.'
+                   << std::setw(3) << std::setfill('0') << e.timestampNs % 1000 << std::setfill(' ')
+                   << ",\"pid\":1,\"tid\":" << tid + 1 << '}';
+                first = false;
+            }
+        }
+        os << "\n],\"displayTimeUnit\":\"ns\"}" << std::endl;
+    }
+};
+
+// Records nothing during constant evaluation, so traced trees stay usable in constexpr code.
+class AVLTraceScope {
+    AVLTraceRing* ring = nullptr;
+    AVLTraceEvent event;
+
+public:
+    constexpr explicit AVLTraceScope(const AVLTraceEvent event) : event(event) {
+        if !consteval {
+            ring = &AVLTraceRegistry::instance().local();
+            ring->push(event, true);
+        }
+    }
+
+    AVLTraceScope(const AVLTraceScope&) = delete;
+    AVLTraceScope& operator=(const AVLTraceScope&) = delete;
+
+    constexpr ~AVLTraceScope() {
+        if (ring) ring->push(event, false);
+    }
+};
+
+#endif //AVLTRACE_H
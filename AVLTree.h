@@ -0,0 +1,736 @@
+#ifndef AVLTREE_H
+#define AVLTREE_H
+
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "AVLBalance.h"
+#include "AVLKeyPrefix.h"
+#include "TreePrinter.h"
+
+class AVLReclaimer;
+
+template <typename T>
+concept Comparable = requires(T a, T b) {
+    { a < b } -> std::convertible_to<bool>;
+    { a > b } -> std::convertible_to<bool>;
+    { a == b } -> std::convertible_to<bool>;
+};
+
+// Default distance of AVLTree::nearest(): |a - b| for arithmetic keys and anything else with
+// a meaningful difference, such as std::chrono time points.
+struct AVLAbsoluteDifference {
+    template <typename T>
+    [[nodiscard]] constexpr auto operator()(const T& a, const T& b) const {
+        return a < b ? b - a : a - b;
+    }
+};
+
+struct AVLTreeStats {
+    std::size_t nodeCount = 0;
+    int height = 0;
+    // Worst case height of an AVL tree with nodeCount nodes: 1.4405 log2(n + 2) - 0.3277.
+    double heightBound = 0;
+    // depthHistogram[d] is the number of nodes at depth d, the root being depth 0.
+    std::vector<std::size_t> depthHistogram;
+    // Nodes visited by a successful search, averaged over all keys.
+    double averageSearchDepth = 0;
+    // balanceFactors[bf + 1] counts nodes with balance factor bf.
+    std::array<std::size_t, 3> balanceFactors{};
+    std::size_t nodeBytes = 0;
+    // Estimated for a glibc-style malloc: 8 byte chunk header, 16 byte granularity, 32 byte minimum.
+    std::size_t allocatorOverheadBytes = 0;
+    // Mean absolute address distance between a node and its children; small values mean the
+    // nodes of a search path tend to share pages and cache lines.
+    double averageParentChildDistance = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const AVLTreeStats& s) {
+    os << "nodes=" << s.nodeCount
+       << " height=" << s.height
+       << " height_bound=" << s.heightBound
+       << " avg_search_depth=" << s.averageSearchDepth
+       << " balance_factors(-1/0/+1)=" << s.balanceFactors[0] << '/' << s.balanceFactors[1] << '/' << s.balanceFactors[2]
+       << " node_bytes=" << s.nodeBytes
+       << " allocator_overhead_bytes=" << s.allocatorOverheadBytes
+       << " avg_parent_child_distance=" << s.averageParentChildDistance
+       << " depth_histogram=";
+    for (std::size_t d = 0; d < s.depthHistogram.size(); ++d) {
+        os << (d ? "," : "") << s.depthHistogram[d];
+    }
+    return os;
+}
+
+template <Comparable T>
+class AVLTree : public AVLBalance<AVLTree<T>> {
+    struct Node {
+        T value;
+        [[no_unique_address]] AVLKeyPrefix<T> prefix;
+        std::unique_ptr<Node> left;
+        std::unique_ptr<Node> right;
+        int height;
+
+        constexpr explicit Node(T val)
+            : value(std::move(val)), prefix(value), left(nullptr), right(nullptr), height(1) {}
+    };
+
+    // A searched value and its key prefix, computed once per operation. For string keys most
+    // comparisons then end at the prefixes cached in the nodes (see AVLKeyPrefix.h).
+    struct Probe {
+        const T& value;
+        [[no_unique_address]] AVLKeyPrefix<T> prefix;
+
+        constexpr explicit Probe(const T& value) : value(value), prefix(value) {}
+
+        // Negative, zero or positive as value is less than, equal to or greater than node.value.
+        [[nodiscard]] constexpr int compare(const Node& node) const {
+            if constexpr (AVLKeyPrefix<T>::enabled) {
+                if (prefix.bits != node.prefix.bits) return prefix.bits < node.prefix.bits ? -1 : 1;
+                return AVLKeyPrefix<T>::compareTail(value, node.value);
+            } else {
+                if (value < node.value) return -1;
+                return value > node.value ? 1 : 0;
+            }
+        }
+    };
+
+    // Detached nodes freed a batch at a time. Each node is unlinked from its children before
+    // it is deleted, so nothing recurses and the stack stays as deep as the tree.
+    struct RetiredNodes {
+        std::vector<std::unique_ptr<Node>> pending;
+        std::size_t freed = 0;
+
+        explicit RetiredNodes(std::unique_ptr<Node> root) {
+            if (root) pending.push_back(std::move(root));
+        }
+
+        bool reclaim(std::size_t budget) {
+            for (; budget > 0 && !pending.empty(); --budget) {
+                std::unique_ptr<Node> node = std::move(pending.back());
+                pending.pop_back();
+                if (node->left) pending.push_back(std::move(node->left));
+                if (node->right) pending.push_back(std::move(node->right));
+                ++freed;
+            }
+            return pending.empty();
+        }
+    };
+
+    std::unique_ptr<Node> root;
+    std::size_t count = 0;
+    friend AVLBalance<AVLTree>;
+
+    using AVLBalance<AVLTree>::height;
+    using AVLBalance<AVLTree>::balanceFactor;
+    using AVLBalance<AVLTree>::balance;
+    using AVLBalance<AVLTree>::updateHeight;
+#ifdef AVL_TREE_STATS
+    using AVLBalance<AVLTree>::counters;
+    using AVLBalance<AVLTree>::countShared;
+    using AVLBalance<AVLTree>::finishUpdate;
+#endif
+
+    [[nodiscard]] static constexpr Node& nodeAt(const std::unique_ptr<Node>& link) { return *link; }
+
+    [[nodiscard]] static constexpr const Node& nodeAt(const Node* node) { return *node; }
+
+    // value is only moved from when the new node is created, so the descent does not copy it
+    // at every level; probe refers to it until then. stored receives the address of the value
+    // now in the tree.
+    constexpr std::unique_ptr<Node> insert(std::unique_ptr<Node> node, const Probe& probe, T& value,
+                                           const T*& stored) {
+        if (!node) {
+            ++count;
+            AVL_COUNT(++counters.allocations);
+            auto created = std::make_unique<Node>(std::move(value));
+            stored = &created->value;
+            return created;
+        }
+
+        const int order = probe.compare(*node);
+        if (order < 0) {
+            AVL_COUNT(++counters.updateComparisons);
+            node->left = insert(std::move(node->left), probe, value, stored);
+        } else if (order > 0) {
+            AVL_COUNT(counters.updateComparisons += 2);
+            node->right = insert(std::move(node->right), probe, value, stored);
+        } else {
+            AVL_COUNT(counters.updateComparisons += 2);
+            stored = &node->value;
+            return std::move(node);
+        }
+
+        return balance(std::move(node));
+    }
+
+    // Unlinks the smallest node of a non-empty subtree and returns the rebalanced rest plus
+    // the detached node.
+    constexpr std::pair<std::unique_ptr<Node>, std::unique_ptr<Node>> detachMin(std::unique_ptr<Node> node) {
+        if (!node->left) {
+            auto rest = std::move(node->right);
+            return {std::move(rest), std::move(node)};
+        }
+
+        auto [rest, min] = detachMin(std::move(node->left));
+        node->left = std::move(rest);
+        return {balance(std::move(node)), std::move(min)};
+    }
+
+    constexpr std::unique_ptr<Node> remove(std::unique_ptr<Node> node, const Probe& probe) {
+        if (!node) return nullptr;
+
+        const int order = probe.compare(*node);
+        if (order < 0) {
+            AVL_COUNT(++counters.updateComparisons);
+            node->left = remove(std::move(node->left), probe);
+        } else if (order > 0) {
+            AVL_COUNT(counters.updateComparisons += 2);
+            node->right = remove(std::move(node->right), probe);
+        } else {
+            AVL_COUNT(counters.updateComparisons += 2);
+            if (!node->left) {
+                --count;
+                AVL_COUNT(++counters.frees);
+                return std::move(node->right);
+            }
+            if (!node->right) {
+                --count;
+                AVL_COUNT(++counters.frees);
+                return std::move(node->left);
+            }
+
+            // The successor node takes the removed node's place instead of having its value
+            // copied over, so every remaining value keeps its address (see find()).
+            auto [rest, successor] = detachMin(std::move(node->right));
+            successor->left = std::move(node->left);
+            successor->right = std::move(rest);
+            --count;
+            AVL_COUNT(++counters.frees);
+            return balance(std::move(successor));
+        }
+
+        return balance(std::move(node));
+    }
+
+    // Joins two trees and a node whose value lies between them. The taller tree's spine is
+    // followed down to a subtree of about the other tree's height, so the work is
+    // O(|height(left) - height(right)| + 1), and the path back up is rebalanced.
+    std::unique_ptr<Node> join(std::unique_ptr<Node> left, std::unique_ptr<Node> middle,
+                               std::unique_ptr<Node> right) {
+        if (height(left) > height(right) + 1) {
+            left->right = join(std::move(left->right), std::move(middle), std::move(right));
+            return balance(std::move(left));
+        }
+        if (height(right) > height(left) + 1) {
+            right->left = join(std::move(left), std::move(middle), std::move(right->left));
+            return balance(std::move(right));
+        }
+        middle->left = std::move(left);
+        middle->right = std::move(right);
+        updateHeight(middle);
+        return middle;
+    }
+
+    std::unique_ptr<Node> join(std::unique_ptr<Node> left, std::unique_ptr<Node> right) {
+        if (!right) return left;
+        auto [rest, min] = detachMin(std::move(right));
+        return join(std::move(left), std::move(min), std::move(rest));
+    }
+
+    // Splits a subtree into the values less than probe's, plus those equal to it when
+    // equalGoesLeft, and the rest. O(log n): one join per level of the descent.
+    std::pair<std::unique_ptr<Node>, std::unique_ptr<Node>> split(std::unique_ptr<Node> node, const Probe& probe,
+                                                                  const bool equalGoesLeft) {
+        if (!node) return {};
+
+        const int order = probe.compare(*node);
+        AVL_COUNT(counters.updateComparisons += 2);
+        if (order > 0 || (order == 0 && equalGoesLeft)) {
+            auto left = std::move(node->left);
+            auto [less, rest] = split(std::move(node->right), probe, equalGoesLeft);
+            return {join(std::move(left), std::move(node), std::move(less)), std::move(rest)};
+        }
+
+        auto right = std::move(node->right);
+        auto [less, rest] = split(std::move(node->left), probe, equalGoesLeft);
+        return {std::move(less), join(std::move(rest), std::move(node), std::move(right))};
+    }
+
+    // Removes the values sorted[first, last) from a subtree. Subtrees without values to remove
+    // are returned untouched and every other node is joined back once, so the work is
+    // O(k log(n / k)) with each node on an affected path rebalanced a single time. A removed
+    // node is freed only after the recursion below it, which never looks at its value again.
+    template <typename Range, typename Proj>
+    std::unique_ptr<Node> removeSorted(std::unique_ptr<Node> node, const Range& sorted, std::size_t first,
+                                       const std::size_t last, Proj& proj) {
+        if (!node || first == last) return node;
+
+        // First value not less than node's.
+        std::size_t middle = first;
+        for (std::size_t high = last; middle < high;) {
+            const std::size_t probe = middle + (high - middle) / 2;
+            AVL_COUNT(++counters.updateComparisons);
+            if (std::invoke(proj, std::ranges::begin(sorted)[probe]) < node->value) {
+                middle = probe + 1;
+            } else {
+                high = probe;
+            }
+        }
+        AVL_COUNT(counters.updateComparisons += middle < last);
+        const bool found = middle < last && !(node->value < std::invoke(proj, std::ranges::begin(sorted)[middle]));
+
+        auto left = removeSorted(std::move(node->left), sorted, first, middle, proj);
+        auto right = removeSorted(std::move(node->right), sorted, middle + found, last, proj);
+        if (!found) return join(std::move(left), std::move(node), std::move(right));
+
+        --count;
+        AVL_COUNT(++counters.frees);
+        node.reset();
+        return join(std::move(left), std::move(right));
+    }
+
+    // Frees a detached subtree without recursing and returns how many values it held.
+    std::size_t release(std::unique_ptr<Node> node) {
+        RetiredNodes nodes(std::move(node));
+        nodes.reclaim(nodes.pending.empty() ? 0 : count);
+        count -= nodes.freed;
+        AVL_COUNT(counters.frees += nodes.freed);
+        AVL_COUNT(finishUpdate());
+        return nodes.freed;
+    }
+
+    // Perfectly balanced subtree over values[first, last), which is a valid AVL tree since
+    // sibling subtree sizes differ by at most one.
+    constexpr std::unique_ptr<Node> buildSorted(std::vector<T>& values, const std::size_t first,
+                                                const std::size_t last) {
+        if (first == last) return nullptr;
+
+        const std::size_t middle = first + (last - first) / 2;
+        auto node = std::make_unique<Node>(std::move(values[middle]));
+        node->left = buildSorted(values, first, middle);
+        node->right = buildSorted(values, middle + 1, last);
+        updateHeight(node);
+        return node;
+    }
+
+    // Copies a subtree node by node, heights included, so the copy has the same shape and
+    // needs no comparisons or rotations. Nodes are allocated in preorder, the order of a
+    // descent.
+    [[nodiscard]] static constexpr std::unique_ptr<Node> cloneSubtree(const Node* node) {
+        if (!node) return nullptr;
+
+        auto copy = std::make_unique<Node>(node->value);
+        copy->height = node->height;
+        copy->left = cloneSubtree(node->left.get());
+        copy->right = cloneSubtree(node->right.get());
+        return copy;
+    }
+
+    // Splits the thread budget between the two subtrees until each task has one thread left
+    // and copies its subtree sequentially.
+    template <typename Spawn>
+    [[nodiscard]] static std::unique_ptr<Node> cloneSubtree(const Node* node, const std::size_t threads, Spawn& spawn) {
+        if (!node || threads <= 1) return cloneSubtree(node);
+
+        auto copy = std::make_unique<Node>(node->value);
+        copy->height = node->height;
+        auto left = spawn([node, threads, &spawn] {
+            return cloneSubtree(node->left.get(), threads / 2, spawn);
+        });
+        copy->right = cloneSubtree(node->right.get(), threads - threads / 2, spawn);
+        copy->left = left.get();
+        return copy;
+    }
+
+    constexpr const Node* search(const Node* node, const Probe& probe, std::uint64_t& comparisons) const {
+        if (!node) return nullptr;
+
+        const int order = probe.compare(*node);
+        if (order < 0) {
+            ++comparisons;
+            return search(node->left.get(), probe, comparisons);
+        }
+        comparisons += 2;
+        if (order > 0) return search(node->right.get(), probe, comparisons);
+        return node; // Found
+    }
+
+    // One search from the root. Comparisons are summed locally and counted once, so concurrent
+    // readers of a shared tree touch the counters once per lookup.
+    constexpr const Node* search(const Probe& probe) const {
+        std::uint64_t comparisons = 0;
+        const Node* node = search(root.get(), probe, comparisons);
+        AVL_COUNT(countShared(counters.searches, 1));
+        AVL_COUNT(countShared(counters.searchComparisons, comparisons));
+        return node;
+    }
+
+    // Closest value below value (above unless below), or value itself when inclusive.
+    [[nodiscard]] constexpr const T* neighbour(const T& value, const bool below, const bool inclusive) const {
+        const Probe probe(value);
+        const T* candidate = nullptr;
+        for (const Node* node = root.get(); node;) {
+            const int order = probe.compare(*node);
+            if (order == 0 && inclusive) return &node->value;
+            if (below ? order > 0 : order < 0) {
+                candidate = &node->value;
+                node = below ? node->right.get() : node->left.get();
+            } else {
+                node = below ? node->left.get() : node->right.get();
+            }
+        }
+        return candidate;
+    }
+
+    [[nodiscard]] static std::size_t mallocChunkSize(const std::size_t requested) {
+        return std::max<std::size_t>(32, (requested + 8 + 15) & ~std::size_t{15});
+    }
+
+    void collectStats(const Node* node, const std::size_t depth, AVLTreeStats& stats, double& depthSum,
+                      double& distanceSum, std::size_t& links) const {
+        if (!node) return;
+
+        ++stats.nodeCount;
+        depthSum += static_cast<double>(depth + 1);
+        if (stats.depthHistogram.size() <= depth) stats.depthHistogram.resize(depth + 1);
+        ++stats.depthHistogram[depth];
+        ++stats.balanceFactors[balanceFactor(node) + 1];
+
+        for (const Node* child : {node->left.get(), node->right.get()}) {
+            if (!child) continue;
+            const auto parentAddress = reinterpret_cast<std::uintptr_t>(node);
+            const auto childAddress = reinterpret_cast<std::uintptr_t>(child);
+            distanceSum += static_cast<double>(parentAddress > childAddress ? parentAddress - childAddress
+                                                                              : childAddress - parentAddress);
+            ++links;
+            collectStats(child, depth + 1, stats, depthSum, distanceSum, links);
+        }
+    }
+
+    constexpr void inorderTraversal(const Node* node, auto& visitor) const {
+        if (!node) return;
+
+        inorderTraversal(node->left.get(), visitor);
+        visitor(node->value);
+        inorderTraversal(node->right.get(), visitor);
+    }
+
+    constexpr void rangeTraversal(const Node* node, const Probe& low, const Probe& high, auto& visitor) const {
+        if (!node) return;
+
+        // With prefixes one three-way compare per bound is cheapest; plain keys keep the
+        // short-circuiting comparisons, which skip work at nodes outside the range.
+        if constexpr (AVLKeyPrefix<T>::enabled) {
+            const int fromLow = low.compare(*node);
+            const int fromHigh = high.compare(*node);
+            if (fromLow < 0) {
+                rangeTraversal(node->left.get(), low, high, visitor);
+            }
+            if (fromLow <= 0 && fromHigh >= 0) {
+                visitor(node->value);
+            }
+            if (fromHigh > 0) {
+                rangeTraversal(node->right.get(), low, high, visitor);
+            }
+        } else {
+            if (low.value < node->value) {
+                rangeTraversal(node->left.get(), low, high, visitor);
+            }
+            if (!(node->value < low.value) && !(node->value > high.value)) {
+                visitor(node->value);
+            }
+            if (high.value > node->value) {
+                rangeTraversal(node->right.get(), low, high, visitor);
+            }
+        }
+    }
+
+public:
+    using value_type = T;
+
+    constexpr AVLTree() : root(nullptr) {}
+
+    // O(n) structural copy; see clone() for a parallel one.
+    constexpr AVLTree(const AVLTree& other)
+        : AVLBalance<AVLTree>(), root(cloneSubtree(other.root.get())), count(other.count) {
+        AVL_COUNT(counters.allocations += count);
+    }
+
+    constexpr AVLTree(AVLTree&& other) noexcept
+        : AVLBalance<AVLTree>(std::move(other)), root(std::move(other.root)), count(std::exchange(other.count, 0)) {}
+
+    constexpr AVLTree& operator=(const AVLTree& other) {
+        if (this != &other) AVLTree(other).swap(*this);
+        return *this;
+    }
+
+    constexpr AVLTree& operator=(AVLTree&& other) noexcept {
+        AVLTree(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    constexpr void swap(AVLTree& other) noexcept {
+        using std::swap;
+        swap(static_cast<AVLBalance<AVLTree>&>(*this), static_cast<AVLBalance<AVLTree>&>(other));
+        swap(root, other.root);
+        swap(count, other.count);
+    }
+
+    friend constexpr void swap(AVLTree& a, AVLTree& b) noexcept { a.swap(b); }
+
+    // Structural copy with the subtrees below the root copied on up to threads threads at once.
+    // spawn(task) starts task on another thread and returns a handle whose get() waits for the
+    // result; AVLParallelClone.h passes std::async. Worth it for large trees only; each thread
+    // still allocates its nodes one by one.
+    template <typename Spawn>
+    [[nodiscard]] AVLTree clone(const std::size_t threads, Spawn spawn) const {
+        AVLTree copy;
+        copy.root = cloneSubtree(root.get(), threads, spawn);
+        copy.count = count;
+        AVL_COUNT(copy.counters.allocations += count);
+        return copy;
+    }
+
+    // Builds a tree from strictly increasing values in O(n), without comparisons or rotations.
+    [[nodiscard]] static constexpr AVLTree fromSorted(std::vector<T> values) {
+        AVLTree tree;
+        tree.root = tree.buildSorted(values, 0, values.size());
+        tree.count = values.size();
+        AVL_COUNT(tree.counters.allocations += values.size());
+        return tree;
+    }
+
+    // Returns the stored value, the existing one if an equal value was already present. Like
+    // find(), the pointer stays valid until that value is removed.
+    constexpr const T* insert(T value) {
+        AVL_TRACE_SCOPE(Insert);
+        const T* stored = nullptr;
+        root = insert(std::move(root), Probe(value), value, stored);
+        AVL_COUNT(finishUpdate());
+        return stored;
+    }
+
+    constexpr void remove(const T& value) {
+        AVL_TRACE_SCOPE(Remove);
+        root = remove(std::move(root), Probe(value));
+        AVL_COUNT(finishUpdate());
+    }
+
+    constexpr void clear() {
+        AVL_COUNT(counters.frees += count);
+        root.reset();
+        count = 0;
+    }
+
+    // Empties the tree in O(1) and leaves freeing the nodes to reclaimer's thread. A template, so
+    // only callers of this overload include AVLReclaimer.h and its threading headers.
+    template <std::same_as<AVLReclaimer> Reclaimer>
+    void clear(Reclaimer& reclaimer) {
+        if (!root) return;
+
+        AVL_COUNT(counters.frees += count);
+        reclaimer.retire(RetiredNodes(std::move(root)));
+        count = 0;
+    }
+
+    // Removes every value in [low, high] and returns how many there were. The range is cut out
+    // with two splits and the remaining trees are joined, so only O(log n) nodes are
+    // rebalanced; the k removed nodes are then freed in one pass.
+    std::size_t erase_range(const T& low, const T& high) {
+        AVL_TRACE_SCOPE(Remove);
+        if (high < low) return 0;
+
+        auto [less, rest] = split(std::move(root), Probe(low), false);
+        auto [inside, greater] = split(std::move(rest), Probe(high), true);
+        root = join(std::move(less), std::move(greater));
+        return release(std::move(inside));
+    }
+
+    // Removes every value less than value.
+    std::size_t erase_below(const T& value) {
+        AVL_TRACE_SCOPE(Remove);
+        auto [less, rest] = split(std::move(root), Probe(value), false);
+        root = std::move(rest);
+        return release(std::move(less));
+    }
+
+    // Removes every value greater than value.
+    std::size_t erase_above(const T& value) {
+        AVL_TRACE_SCOPE(Remove);
+        auto [rest, greater] = split(std::move(root), Probe(value), true);
+        root = std::move(rest);
+        return release(std::move(greater));
+    }
+
+    // Removes the values of sorted, which must be strictly increasing after applying proj, and
+    // returns how many were present. Cheaper than one remove() per value: subtrees holding none
+    // of them are skipped and each affected node is rebalanced once.
+    template <std::ranges::random_access_range Range, typename Proj = std::identity>
+    std::size_t removeSorted(const Range& sorted, Proj proj = {}) {
+        AVL_TRACE_SCOPE(Remove);
+        const std::size_t before = count;
+        root = removeSorted(std::move(root), sorted, 0, std::ranges::size(sorted), proj);
+        AVL_COUNT(finishUpdate());
+        return before - count;
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const { return count; }
+
+    [[nodiscard]] constexpr bool empty() const { return count == 0; }
+
+    [[nodiscard]] constexpr bool contains(const T& value) const {
+        AVL_TRACE_SCOPE(Search);
+        return search(Probe(value)) != nullptr;
+    }
+
+    // The returned pointer stays valid until that value is removed or the tree is destroyed;
+    // inserts, rotations and removals of other values never move a stored value.
+    [[nodiscard]] constexpr const T* find(const T& value) const {
+        AVL_TRACE_SCOPE(Search);
+        const Node* node = search(Probe(value));
+        return node ? &node->value : nullptr;
+    }
+
+    // Smallest stored value that is not less than value, or nullptr.
+    [[nodiscard]] constexpr const T* lower_bound(const T& value) const {
+        const Probe probe(value);
+        const T* candidate = nullptr;
+        for (const Node* node = root.get(); node;) {
+            if (probe.compare(*node) > 0) {
+                node = node->right.get();
+            } else {
+                candidate = &node->value;
+                node = node->left.get();
+            }
+        }
+        return candidate;
+    }
+
+    // Largest stored value less than value, or nullptr.
+    [[nodiscard]] constexpr const T* predecessor(const T& value) const { return neighbour(value, true, false); }
+
+    // Smallest stored value greater than value, or nullptr.
+    [[nodiscard]] constexpr const T* successor(const T& value) const { return neighbour(value, false, false); }
+
+    // Largest stored value not greater than value, or nullptr.
+    [[nodiscard]] constexpr const T* floor(const T& value) const { return neighbour(value, true, true); }
+
+    // Smallest stored value not less than value, or nullptr; same as lower_bound().
+    [[nodiscard]] constexpr const T* ceiling(const T& value) const { return neighbour(value, false, true); }
+
+    // The k stored values closest to value by distance(value, stored), nearest first, with
+    // ties going to the smaller value. Two stacks hold the paths to value's predecessor and
+    // successor and are advanced outward like inorder iterators, so this is O(log n + k).
+    template <typename Distance = AVLAbsoluteDifference>
+    [[nodiscard]] constexpr std::vector<const T*> nearest(const T& value, const std::size_t k,
+                                                          Distance distance = {}) const {
+        const Probe probe(value);
+        std::vector<const Node*> below;
+        std::vector<const Node*> above;
+        for (const Node* node = root.get(); node;) {
+            if (probe.compare(*node) > 0) {
+                below.push_back(node);
+                node = node->right.get();
+            } else {
+                above.push_back(node);
+                node = node->left.get();
+            }
+        }
+
+        std::vector<const T*> result;
+        result.reserve(std::min(k, count));
+        while (result.size() < k && (!below.empty() || !above.empty())) {
+            const bool takeBelow = above.empty() ||
+                                   (!below.empty() && !(distance(value, above.back()->value) <
+                                                        distance(value, below.back()->value)));
+            if (takeBelow) {
+                const Node* node = below.back();
+                below.pop_back();
+                result.push_back(&node->value);
+                for (const Node* next = node->left.get(); next; next = next->right.get()) below.push_back(next);
+            } else {
+                const Node* node = above.back();
+                above.pop_back();
+                result.push_back(&node->value);
+                for (const Node* next = node->right.get(); next; next = next->left.get()) above.push_back(next);
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] constexpr std::optional<T> get(const T& value) const {
+        AVL_TRACE_SCOPE(Search);
+        const Node* node = search(Probe(value));
+        return node ? std::optional<T>(node->value) : std::nullopt;
+    }
+
+    // Walks the whole tree once, O(n).
+    [[nodiscard]] AVLTreeStats stats() const {
+        AVLTreeStats stats;
+        double depthSum = 0;
+        double distanceSum = 0;
+        std::size_t links = 0;
+        collectStats(root.get(), 0, stats, depthSum, distanceSum, links);
+
+        const auto n = static_cast<double>(stats.nodeCount);
+        stats.height = height(root.get());
+        stats.heightBound = stats.nodeCount ? 1.4405 * std::log2(n + 2) - 0.3277 : 0;
+        stats.averageSearchDepth = stats.nodeCount ? depthSum / n : 0;
+        stats.nodeBytes = stats.nodeCount * sizeof(Node);
+        stats.allocatorOverheadBytes = stats.nodeCount * (mallocChunkSize(sizeof(Node)) - sizeof(Node));
+        stats.averageParentChildDistance = links ? distanceSum / static_cast<double>(links) : 0;
+        return stats;
+    }
+
+    template <typename Visitor>
+    constexpr void inorder(Visitor visitor) const {
+        inorderTraversal(root.get(), visitor);
+    }
+
+    template <typename Visitor>
+    constexpr void range(const T& low, const T& high, Visitor visitor) const {
+        rangeTraversal(root.get(), Probe(low), Probe(high), visitor);
+    }
+
+    void print(std::ostream& os = std::cout) const {
+        os << "Tree structure:" << std::endl;
+
+        auto labelFn = [this](const Node* node) -> std::string {
+            if (!node) return "";
+            std::stringstream ss;
+            ss << node->value << "[" << balanceFactor(node) << "]";
+            return ss.str();
+        };
+
+        auto leftFn = [](const Node* node) -> const Node* {
+            return node ? node->left.get() : nullptr;
+        };
+
+        auto rightFn = [](const Node* node) -> const Node* {
+            return node ? node->right.get() : nullptr;
+        };
+
+        TreePrinter<T, Node> printer(labelFn, leftFn, rightFn, os);
+        printer.setSquareBranches(true);
+        printer.setHspace(3);
+        printer.printTree(root.get());
+
+        os << "\nInorder traversal: ";
+        inorder([&os](const T& value) { os << value << " "; });
+        os << std::endl;
+    }
+};
+
+#endif //AVLTREE_H
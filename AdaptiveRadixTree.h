@@ -0,0 +1,703 @@
+#ifndef ADAPTIVERADIXTREE_H
+#define ADAPTIVERADIXTREE_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Byte strings whose lexicographic order (as unsigned bytes) matches the key order. Integers
+// are written big-endian with the sign bit flipped; strings are their own bytes.
+template <typename T>
+struct ARTKeyTraits;
+
+template <std::integral T>
+struct ARTKeyTraits<T> {
+    using Buffer = std::array<char, sizeof(T)>;
+
+    static std::string_view encode(const T& value, Buffer& buffer) {
+        using Unsigned = std::make_unsigned_t<T>;
+        auto bits = static_cast<Unsigned>(value);
+        if constexpr (std::is_signed_v<T>) bits ^= static_cast<Unsigned>(Unsigned{1} << (sizeof(T) * 8 - 1));
+        for (std::size_t i = sizeof(T); i-- > 0;) {
+            buffer[i] = static_cast<char>(bits & 0xff);
+            bits = static_cast<Unsigned>(bits >> 7 >> 1);
+        }
+        return {buffer.data(), buffer.size()};
+    }
+};
+
+template <>
+struct ARTKeyTraits<std::string> {
+    struct Buffer {};
+
+    static std::string_view encode(const std::string& value, Buffer&) { return value; }
+};
+
+template <typename T>
+concept ARTKey = std::totally_ordered<T> && requires(const T& value, typename ARTKeyTraits<T>::Buffer& buffer) {
+    { ARTKeyTraits<T>::encode(value, buffer) } -> std::same_as<std::string_view>;
+};
+
+// Adaptive Radix Tree (Leis et al., ICDE 2013) as an ordered set. Inner nodes branch on one
+// key byte and come in four sizes, Node4, Node16, Node48 and Node256, grown and shrunk as
+// children come and go; Node16 is searched with one SSE2 compare. Every inner node stores the
+// bytes all keys below it share (path compression), so a descent costs one step per
+// distinguishing byte rather than one comparison of whole keys per level, which pays off for
+// long common prefixes such as paths and URLs.
+//
+// A key that is a proper prefix of other keys ends at an inner node and is kept there as its
+// terminal leaf, which sorts before all of the node's children. Leaves never move, so
+// pointers returned by insert(), find() and lower_bound() stay valid until that key is removed.
+template <ARTKey T>
+class AdaptiveRadixTree {
+    using Traits = ARTKeyTraits<T>;
+
+    enum class Kind : std::uint8_t { Leaf, Node4, Node16, Node48, Node256 };
+
+    struct Node;
+
+    struct NodeDeleter {
+        void operator()(Node* node) const;
+    };
+
+    using NodePtr = std::unique_ptr<Node, NodeDeleter>;
+
+    struct Node {
+        Kind kind;
+    };
+
+    struct Leaf : Node {
+        T value;
+
+        explicit Leaf(T val) : Node{Kind::Leaf}, value(std::move(val)) {}
+    };
+
+    struct Inner : Node {
+        std::uint16_t count = 0;
+        std::string prefix;
+        NodePtr terminal;
+
+        explicit Inner(const Kind kind) : Node{kind} {}
+    };
+
+    struct Node4 : Inner {
+        std::array<unsigned char, 4> keys{};
+        std::array<NodePtr, 4> children;
+
+        Node4() : Inner(Kind::Node4) {}
+    };
+
+    struct Node16 : Inner {
+        alignas(16) std::array<unsigned char, 16> keys{};
+        std::array<NodePtr, 16> children;
+
+        Node16() : Inner(Kind::Node16) {}
+    };
+
+    // index[byte] is the child's slot plus one, 0 when absent.
+    struct Node48 : Inner {
+        std::array<std::uint8_t, 256> index{};
+        std::array<NodePtr, 48> children;
+
+        Node48() : Inner(Kind::Node48) {}
+    };
+
+    struct Node256 : Inner {
+        std::array<NodePtr, 256> children;
+
+        Node256() : Inner(Kind::Node256) {}
+    };
+
+    template <typename From, typename To>
+    using LikeConst = std::conditional_t<std::is_const_v<From>, const To, To>;
+
+    NodePtr root;
+    std::size_t count = 0;
+
+    [[nodiscard]] static std::string_view keyOf(const Leaf& leaf, typename Traits::Buffer& buffer) {
+        return Traits::encode(leaf.value, buffer);
+    }
+
+    template <typename Concrete>
+    [[nodiscard]] static NodePtr make() {
+        return NodePtr(new Concrete());
+    }
+
+    [[nodiscard]] static NodePtr makeLeaf(T value) {
+        return NodePtr(new Leaf(std::move(value)));
+    }
+
+    template <typename InnerType>
+    [[nodiscard]] static auto findChild(InnerType& node, const unsigned char byte)
+        -> LikeConst<InnerType, NodePtr>* {
+        switch (node.kind) {
+            case Kind::Node4: {
+                auto& n = static_cast<LikeConst<InnerType, Node4>&>(node);
+                for (std::size_t i = 0; i < n.count; ++i) {
+                    if (n.keys[i] == byte) return &n.children[i];
+                }
+                return nullptr;
+            }
+            case Kind::Node16: {
+                auto& n = static_cast<LikeConst<InnerType, Node16>&>(node);
+#if defined(__SSE2__)
+                const __m128i keys = _mm_load_si128(reinterpret_cast<const __m128i*>(n.keys.data()));
+                const __m128i hits = _mm_cmpeq_epi8(keys, _mm_set1_epi8(static_cast<char>(byte)));
+                const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(hits)) & ((1u << n.count) - 1);
+                return mask ? &n.children[std::countr_zero(mask)] : nullptr;
+#else
+                for (std::size_t i = 0; i < n.count; ++i) {
+                    if (n.keys[i] == byte) return &n.children[i];
+                }
+                return nullptr;
+#endif
+            }
+            case Kind::Node48: {
+                auto& n = static_cast<LikeConst<InnerType, Node48>&>(node);
+                return n.index[byte] ? &n.children[n.index[byte] - 1] : nullptr;
+            }
+            case Kind::Node256: {
+                auto& n = static_cast<LikeConst<InnerType, Node256>&>(node);
+                return n.children[byte] ? &n.children[byte] : nullptr;
+            }
+            case Kind::Leaf: break;
+        }
+        return nullptr;
+    }
+
+    // Calls fn(byte, child) for the children with byte >= from in byte order, until fn returns
+    // false; returns whether it ran to the end.
+    template <typename Fn>
+    static bool forEachChild(const Inner& node, const unsigned from, Fn&& fn) {
+        switch (node.kind) {
+            case Kind::Node4:
+            case Kind::Node16: {
+                const unsigned char* keys = node.kind == Kind::Node4 ? static_cast<const Node4&>(node).keys.data()
+                                                                    : static_cast<const Node16&>(node).keys.data();
+                const NodePtr* children = node.kind == Kind::Node4
+                                              ? static_cast<const Node4&>(node).children.data()
+                                              : static_cast<const Node16&>(node).children.data();
+                for (std::size_t i = 0; i < node.count; ++i) {
+                    if (keys[i] >= from && !fn(keys[i], *children[i])) return false;
+                }
+                return true;
+            }
+            case Kind::Node48: {
+                const auto& n = static_cast<const Node48&>(node);
+                for (unsigned byte = from; byte < 256; ++byte) {
+                    if (n.index[byte] && !fn(static_cast<unsigned char>(byte), *n.children[n.index[byte] - 1])) return false;
+                }
+                return true;
+            }
+            case Kind::Node256: {
+                const auto& n = static_cast<const Node256&>(node);
+                for (unsigned byte = from; byte < 256; ++byte) {
+                    if (n.children[byte] && !fn(static_cast<unsigned char>(byte), *n.children[byte])) return false;
+                }
+                return true;
+            }
+            case Kind::Leaf: break;
+        }
+        return true;
+    }
+
+    template <typename Smaller, typename Larger>
+    static NodePtr moveHeader(Smaller& from, NodePtr to) {
+        auto& inner = static_cast<Larger&>(*to);
+        inner.prefix = std::move(from.prefix);
+        inner.terminal = std::move(from.terminal);
+        return to;
+    }
+
+    // Replaces a full node with the next larger kind holding the same children.
+    static void grow(NodePtr& slot) {
+        switch (slot->kind) {
+            case Kind::Node4: {
+                auto& old = static_cast<Node4&>(*slot);
+                NodePtr grown = moveHeader<Node4, Node16>(old, make<Node16>());
+                auto& n = static_cast<Node16&>(*grown);
+                for (std::size_t i = 0; i < old.count; ++i) {
+                    n.keys[i] = old.keys[i];
+                    n.children[i] = std::move(old.children[i]);
+                }
+                n.count = old.count;
+                slot = std::move(grown);
+                return;
+            }
+            case Kind::Node16: {
+                auto& old = static_cast<Node16&>(*slot);
+                NodePtr grown = moveHeader<Node16, Node48>(old, make<Node48>());
+                auto& n = static_cast<Node48&>(*grown);
+                for (std::size_t i = 0; i < old.count; ++i) {
+                    n.index[old.keys[i]] = static_cast<std::uint8_t>(i + 1);
+                    n.children[i] = std::move(old.children[i]);
+                }
+                n.count = old.count;
+                slot = std::move(grown);
+                return;
+            }
+            case Kind::Node48: {
+                auto& old = static_cast<Node48&>(*slot);
+                NodePtr grown = moveHeader<Node48, Node256>(old, make<Node256>());
+                auto& n = static_cast<Node256&>(*grown);
+                for (unsigned byte = 0; byte < 256; ++byte) {
+                    if (old.index[byte]) n.children[byte] = std::move(old.children[old.index[byte] - 1]);
+                }
+                n.count = old.count;
+                slot = std::move(grown);
+                return;
+            }
+            case Kind::Node256:
+            case Kind::Leaf: break;
+        }
+    }
+
+    // Replaces a sparse node with the next smaller kind; the thresholds sit below the smaller
+    // kind's capacity so a node does not flip back and forth on alternating inserts and removes.
+    static void shrink(NodePtr& slot) {
+        switch (slot->kind) {
+            case Kind::Node16: {
+                auto& old = static_cast<Node16&>(*slot);
+                if (old.count > 3) return;
+                NodePtr shrunk = moveHeader<Node16, Node4>(old, make<Node4>());
+                auto& n = static_cast<Node4&>(*shrunk);
+                for (std::size_t i = 0; i < old.count; ++i) {
+                    n.keys[i] = old.keys[i];
+                    n.children[i] = std::move(old.children[i]);
+                }
+                n.count = old.count;
+                slot = std::move(shrunk);
+                return;
+            }
+            case Kind::Node48: {
+                auto& old = static_cast<Node48&>(*slot);
+                if (old.count > 12) return;
+                NodePtr shrunk = moveHeader<Node48, Node16>(old, make<Node16>());
+                auto& n = static_cast<Node16&>(*shrunk);
+                for (unsigned byte = 0; byte < 256; ++byte) {
+                    if (!old.index[byte]) continue;
+                    n.keys[n.count] = static_cast<unsigned char>(byte);
+                    n.children[n.count++] = std::move(old.children[old.index[byte] - 1]);
+                }
+                slot = std::move(shrunk);
+                return;
+            }
+            case Kind::Node256: {
+                auto& old = static_cast<Node256&>(*slot);
+                if (old.count > 36) return;
+                NodePtr shrunk = moveHeader<Node256, Node48>(old, make<Node48>());
+                auto& n = static_cast<Node48&>(*shrunk);
+                for (unsigned byte = 0; byte < 256; ++byte) {
+                    if (!old.children[byte]) continue;
+                    n.children[n.count] = std::move(old.children[byte]);
+                    n.index[byte] = static_cast<std::uint8_t>(++n.count);
+                }
+                slot = std::move(shrunk);
+                return;
+            }
+            case Kind::Node4:
+            case Kind::Leaf: break;
+        }
+    }
+
+    static void addChild(NodePtr& slot, const unsigned char byte, NodePtr child) {
+        auto& inner = static_cast<Inner&>(*slot);
+        switch (inner.kind) {
+            case Kind::Node4:
+            case Kind::Node16: {
+                const std::size_t capacity = inner.kind == Kind::Node4 ? 4 : 16;
+                if (inner.count == capacity) {
+                    grow(slot);
+                    addChild(slot, byte, std::move(child));
+                    return;
+                }
+                unsigned char* keys = inner.kind == Kind::Node4 ? static_cast<Node4&>(inner).keys.data()
+                                                                : static_cast<Node16&>(inner).keys.data();
+                NodePtr* children = inner.kind == Kind::Node4 ? static_cast<Node4&>(inner).children.data()
+                                                              : static_cast<Node16&>(inner).children.data();
+                std::size_t position = inner.count;
+                while (position > 0 && keys[position - 1] > byte) {
+                    keys[position] = keys[position - 1];
+                    children[position] = std::move(children[position - 1]);
+                    --position;
+                }
+                keys[position] = byte;
+                children[position] = std::move(child);
+                ++inner.count;
+                return;
+            }
+            case Kind::Node48: {
+                auto& n = static_cast<Node48&>(inner);
+                if (n.count == 48) {
+                    grow(slot);
+                    addChild(slot, byte, std::move(child));
+                    return;
+                }
+                std::size_t free = 0;
+                while (n.children[free]) ++free;
+                n.children[free] = std::move(child);
+                n.index[byte] = static_cast<std::uint8_t>(free + 1);
+                ++n.count;
+                return;
+            }
+            case Kind::Node256: {
+                auto& n = static_cast<Node256&>(inner);
+                n.children[byte] = std::move(child);
+                ++n.count;
+                return;
+            }
+            case Kind::Leaf: break;
+        }
+    }
+
+    static void removeChild(Inner& inner, const unsigned char byte) {
+        switch (inner.kind) {
+            case Kind::Node4:
+            case Kind::Node16: {
+                unsigned char* keys = inner.kind == Kind::Node4 ? static_cast<Node4&>(inner).keys.data()
+                                                                : static_cast<Node16&>(inner).keys.data();
+                NodePtr* children = inner.kind == Kind::Node4 ? static_cast<Node4&>(inner).children.data()
+                                                              : static_cast<Node16&>(inner).children.data();
+                std::size_t position = 0;
+                while (keys[position] != byte) ++position;
+                for (; position + 1 < inner.count; ++position) {
+                    keys[position] = keys[position + 1];
+                    children[position] = std::move(children[position + 1]);
+                }
+                children[position].reset();
+                --inner.count;
+                return;
+            }
+            case Kind::Node48: {
+                auto& n = static_cast<Node48&>(inner);
+                n.children[n.index[byte] - 1].reset();
+                n.index[byte] = 0;
+                --n.count;
+                return;
+            }
+            case Kind::Node256: {
+                static_cast<Node256&>(inner).children[byte].reset();
+                --inner.count;
+                return;
+            }
+            case Kind::Leaf: break;
+        }
+    }
+
+    // An inner node left with a single entry is replaced by it: a lone terminal leaf moves up,
+    // a lone child absorbs the node's prefix and branch byte into its own.
+    static void collapse(NodePtr& slot) {
+        auto& inner = static_cast<Inner&>(*slot);
+        if (inner.count + (inner.terminal ? 1 : 0) != 1) return;
+
+        if (inner.terminal) {
+            slot = std::move(inner.terminal);
+            return;
+        }
+
+        unsigned char byte = 0;
+        forEachChild(inner, 0, [&byte](const unsigned char b, const Node&) {
+            byte = b;
+            return false;
+        });
+        NodePtr child = std::move(*findChild(inner, byte));
+        if (child->kind != Kind::Leaf) {
+            auto& childInner = static_cast<Inner&>(*child);
+            childInner.prefix = std::move(inner.prefix) + static_cast<char>(byte) + childInner.prefix;
+        }
+        slot = std::move(child);
+    }
+
+    // Splits off the common part of two paths into a new Node4 whose entries are the two
+    // given ones, each placed under the byte following the common part or as the terminal.
+    static NodePtr branch(std::string prefix, const std::string_view firstKey, NodePtr first,
+                          const std::string_view secondKey, NodePtr second, const std::size_t depth) {
+        NodePtr node = make<Node4>();
+        static_cast<Inner&>(*node).prefix = std::move(prefix);
+        for (auto [key, entry] : {std::pair{firstKey, &first}, std::pair{secondKey, &second}}) {
+            if (key.size() == depth) {
+                static_cast<Inner&>(*node).terminal = std::move(*entry);
+            } else {
+                addChild(node, static_cast<unsigned char>(key[depth]), std::move(*entry));
+            }
+        }
+        return node;
+    }
+
+    const T* insert(NodePtr& slot, const std::string_view key, std::size_t depth, T& value) {
+        if (!slot) {
+            slot = makeLeaf(std::move(value));
+            ++count;
+            return &static_cast<Leaf&>(*slot).value;
+        }
+
+        if (slot->kind == Kind::Leaf) {
+            auto& leaf = static_cast<Leaf&>(*slot);
+            typename Traits::Buffer buffer;
+            const std::string_view existing = keyOf(leaf, buffer);
+            if (existing == key) return &leaf.value;
+
+            const std::size_t common = static_cast<std::size_t>(
+                std::mismatch(existing.begin() + depth, existing.end(), key.begin() + depth, key.end()).first -
+                existing.begin()) - depth;
+            std::string shared(key.substr(depth, common));
+            NodePtr created = makeLeaf(std::move(value));
+            const auto& createdLeaf = static_cast<Leaf&>(*created);
+            typename Traits::Buffer createdBuffer;
+            // key may have viewed the moved-from value, so the new leaf's own bytes are used from
+            // here on; existing views the old leaf, which stays alive inside the new node.
+            const std::string_view createdKey = keyOf(createdLeaf, createdBuffer);
+            slot = branch(std::move(shared), existing, std::move(slot), createdKey, std::move(created), depth + common);
+            ++count;
+            return &createdLeaf.value;
+        }
+
+        auto& inner = static_cast<Inner&>(*slot);
+        const std::string_view rest = key.substr(depth);
+        const std::size_t common = static_cast<std::size_t>(
+            std::mismatch(inner.prefix.begin(), inner.prefix.end(), rest.begin(), rest.end()).first -
+            inner.prefix.begin());
+        if (common < inner.prefix.size()) {
+            const auto oldByte = static_cast<unsigned char>(inner.prefix[common]);
+            std::string shared = inner.prefix.substr(0, common);
+            inner.prefix.erase(0, common + 1);
+            const bool endsHere = key.size() == depth + common;
+            const auto newByte = endsHere ? 0 : static_cast<unsigned char>(key[depth + common]);
+
+            NodePtr created = makeLeaf(std::move(value));
+            const T* stored = &static_cast<Leaf&>(*created).value;
+            NodePtr node = make<Node4>();
+            static_cast<Inner&>(*node).prefix = std::move(shared);
+            addChild(node, oldByte, std::move(slot));
+            if (endsHere) {
+                static_cast<Inner&>(*node).terminal = std::move(created);
+            } else {
+                addChild(node, newByte, std::move(created));
+            }
+            slot = std::move(node);
+            ++count;
+            return stored;
+        }
+
+        depth += inner.prefix.size();
+        if (key.size() == depth) {
+            if (inner.terminal) return &static_cast<Leaf&>(*inner.terminal).value;
+            inner.terminal = makeLeaf(std::move(value));
+            ++count;
+            return &static_cast<Leaf&>(*inner.terminal).value;
+        }
+
+        const auto byte = static_cast<unsigned char>(key[depth]);
+        if (NodePtr* child = findChild(inner, byte)) {
+            return insert(*child, key, depth + 1, value);
+        }
+        NodePtr created = makeLeaf(std::move(value));
+        const T* stored = &static_cast<Leaf&>(*created).value;
+        addChild(slot, byte, std::move(created));
+        ++count;
+        return stored;
+    }
+
+    bool remove(NodePtr& slot, const std::string_view key, std::size_t depth) {
+        if (!slot) return false;
+
+        if (slot->kind == Kind::Leaf) {
+            typename Traits::Buffer buffer;
+            if (keyOf(static_cast<Leaf&>(*slot), buffer) != key) return false;
+            slot.reset();
+            --count;
+            return true;
+        }
+
+        auto& inner = static_cast<Inner&>(*slot);
+        if (key.substr(depth, inner.prefix.size()) != inner.prefix) return false;
+        depth += inner.prefix.size();
+
+        if (key.size() == depth) {
+            if (!inner.terminal) return false;
+            inner.terminal.reset();
+            --count;
+            collapse(slot);
+            return true;
+        }
+
+        const auto byte = static_cast<unsigned char>(key[depth]);
+        NodePtr* child = findChild(inner, byte);
+        if (!child || !remove(*child, key, depth + 1)) return false;
+
+        if (!*child) {
+            removeChild(inner, byte);
+            shrink(slot);
+        }
+        collapse(slot);
+        return true;
+    }
+
+    [[nodiscard]] const Leaf* search(const std::string_view key) const {
+        std::size_t depth = 0;
+        for (const Node* node = root.get(); node;) {
+            if (node->kind == Kind::Leaf) {
+                const auto& leaf = static_cast<const Leaf&>(*node);
+                typename Traits::Buffer buffer;
+                return keyOf(leaf, buffer) == key ? &leaf : nullptr;
+            }
+
+            const auto& inner = static_cast<const Inner&>(*node);
+            if (key.compare(depth, inner.prefix.size(), inner.prefix) != 0) return nullptr;
+            depth += inner.prefix.size();
+            if (key.size() == depth) {
+                return static_cast<const Leaf*>(inner.terminal.get());
+            }
+
+            const NodePtr* child = findChild(inner, static_cast<unsigned char>(key[depth]));
+            node = child ? child->get() : nullptr;
+            ++depth;
+        }
+        return nullptr;
+    }
+
+    // Visits the values of node's subtree in order, skipping those below low when bounded, until
+    // visitor returns false. Returns false once stopped.
+    template <typename Visitor>
+    static bool scan(const Node& node, const std::string_view low, std::size_t depth, bool bounded, Visitor& visitor) {
+        if (node.kind == Kind::Leaf) {
+            const auto& leaf = static_cast<const Leaf&>(node);
+            if (bounded) {
+                typename Traits::Buffer buffer;
+                if (keyOf(leaf, buffer) < low) return true;
+            }
+            return visitor(leaf.value);
+        }
+
+        const auto& inner = static_cast<const Inner&>(node);
+        unsigned from = 0;
+        if (bounded) {
+            const std::string_view rest = low.substr(std::min(depth, low.size()));
+            const auto [prefixEnd, restEnd] = std::mismatch(inner.prefix.begin(), inner.prefix.end(), rest.begin(), rest.end());
+            if (prefixEnd != inner.prefix.end()) {
+                // low ends inside the prefix or differs from it: the whole subtree is on one side.
+                if (restEnd != rest.end() &&
+                    static_cast<unsigned char>(*prefixEnd) < static_cast<unsigned char>(*restEnd)) {
+                    return true;
+                }
+                bounded = false;
+            } else {
+                depth += inner.prefix.size();
+                if (low.size() == depth) {
+                    bounded = false;
+                } else {
+                    from = static_cast<unsigned char>(low[depth]);
+                }
+            }
+        }
+
+        if (!bounded && inner.terminal && !visitor(static_cast<const Leaf&>(*inner.terminal).value)) return false;
+
+        return forEachChild(inner, from, [&](const unsigned char byte, const Node& child) {
+            return scan(child, low, depth + 1, bounded && byte == from, visitor);
+        });
+    }
+
+public:
+    AdaptiveRadixTree() = default;
+
+    AdaptiveRadixTree(const AdaptiveRadixTree&) = delete;
+    AdaptiveRadixTree& operator=(const AdaptiveRadixTree&) = delete;
+
+    // Returns the stored value, the existing one if an equal value was already present.
+    const T* insert(T value) {
+        typename Traits::Buffer buffer;
+        // The key may view value's bytes; the private insert stops reading it once value is moved.
+        const std::string_view key = Traits::encode(value, buffer);
+        return insert(root, key, 0, value);
+    }
+
+    void remove(const T& value) {
+        typename Traits::Buffer buffer;
+        remove(root, Traits::encode(value, buffer), 0);
+    }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        typename Traits::Buffer buffer;
+        return search(Traits::encode(value, buffer)) != nullptr;
+    }
+
+    [[nodiscard]] const T* find(const T& value) const {
+        typename Traits::Buffer buffer;
+        const Leaf* leaf = search(Traits::encode(value, buffer));
+        return leaf ? &leaf->value : nullptr;
+    }
+
+    [[nodiscard]] std::optional<T> get(const T& value) const {
+        const T* found = find(value);
+        return found ? std::optional<T>(*found) : std::nullopt;
+    }
+
+    // Smallest stored value that is not less than value, or nullptr.
+    [[nodiscard]] const T* lower_bound(const T& value) const {
+        if (!root) return nullptr;
+
+        typename Traits::Buffer buffer;
+        const T* result = nullptr;
+        auto first = [&result](const T& candidate) {
+            result = &candidate;
+            return false;
+        };
+        scan(*root, Traits::encode(value, buffer), 0, true, first);
+        return result;
+    }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        if (!root) return;
+
+        auto all = [&visitor](const T& value) {
+            visitor(value);
+            return true;
+        };
+        scan(*root, {}, 0, false, all);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        if (!root) return;
+
+        typename Traits::Buffer buffer;
+        auto upTo = [&visitor, &high](const T& value) {
+            if (high < value) return false;
+            visitor(value);
+            return true;
+        };
+        scan(*root, Traits::encode(low, buffer), 0, true, upTo);
+    }
+};
+
+template <ARTKey T>
+void AdaptiveRadixTree<T>::NodeDeleter::operator()(Node* node) const {
+    switch (node->kind) {
+        case Kind::Leaf: delete static_cast<Leaf*>(node); return;
+        case Kind::Node4: delete static_cast<Node4*>(node); return;
+        case Kind::Node16: delete static_cast<Node16*>(node); return;
+        case Kind::Node48: delete static_cast<Node48*>(node); return;
+        case Kind::Node256: delete static_cast<Node256*>(node); return;
+    }
+}
+
+#endif //ADAPTIVERADIXTREE_H
@@ -0,0 +1,394 @@
+#ifndef BUCKETEDAVLTREE_H
+#define BUCKETEDAVLTREE_H
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "AVLBalance.h"
+#include "AVLTree.h"
+#include "TreePrinter.h"
+
+// AVL tree whose nodes are buckets of up to Capacity sorted values. Buckets cover disjoint,
+// ordered key intervals, so a descent compares against a bucket's first and last value and
+// finishes with a search inside one bucket: a linear, vectorizable count for arithmetic
+// values and a binary search otherwise. The tree has about Capacity / 2 times fewer nodes than
+// AVLTree, so lookups chase fewer pointers and the per-value overhead of links, heights and
+// allocator headers shrinks accordingly. Rotations and rebalancing are AVLTree's (AVLBalance.h).
+//
+// A full bucket is split in half, the upper half becoming a new node. A bucket that drops
+// below a quarter of Capacity takes values from its in-order neighbour, or is merged with it
+// when both fit into one bucket. Values move between and within buckets, so pointers from
+// find() and lower_bound() are only valid until the next insert or remove.
+template <Comparable T, std::size_t Capacity = 32>
+    requires std::default_initializable<T> && std::movable<T>
+class BucketedAVLTree : public AVLBalance<BucketedAVLTree<T, Capacity>> {
+    static_assert(Capacity >= 4, "buckets must hold at least four values");
+
+    static constexpr std::size_t minFill = Capacity / 4;
+
+    struct Node {
+        std::unique_ptr<Node> left;
+        std::unique_ptr<Node> right;
+        int height = 1;
+        std::uint32_t size = 0;
+        std::array<T, Capacity> values{};
+
+        [[nodiscard]] const T& min() const { return values[0]; }
+
+        [[nodiscard]] const T& max() const { return values[size - 1]; }
+
+        // Index of the first value not less than value.
+        [[nodiscard]] std::size_t position(const T& value) const {
+            if constexpr (std::is_arithmetic_v<T>) {
+                std::size_t index = 0;
+                for (std::size_t i = 0; i < size; ++i) index += values[i] < value;
+                return index;
+            } else {
+                return static_cast<std::size_t>(std::lower_bound(values.begin(), values.begin() + size, value) -
+                                                values.begin());
+            }
+        }
+
+        void insertAt(const std::size_t index, T value) {
+            std::move_backward(values.begin() + index, values.begin() + size, values.begin() + size + 1);
+            values[index] = std::move(value);
+            ++size;
+        }
+
+        void eraseAt(const std::size_t index) {
+            std::move(values.begin() + index + 1, values.begin() + size, values.begin() + index);
+            values[--size] = T{};
+        }
+    };
+
+    std::unique_ptr<Node> root;
+    std::size_t count = 0;
+    std::size_t buckets = 0;
+
+    friend AVLBalance<BucketedAVLTree>;
+
+    using AVLBalance<BucketedAVLTree>::height;
+    using AVLBalance<BucketedAVLTree>::balanceFactor;
+    using AVLBalance<BucketedAVLTree>::balance;
+#ifdef AVL_TREE_STATS
+    using AVLBalance<BucketedAVLTree>::counters;
+    using AVLBalance<BucketedAVLTree>::finishUpdate;
+#endif
+
+    [[nodiscard]] static Node& nodeAt(const std::unique_ptr<Node>& link) { return *link; }
+
+    [[nodiscard]] static const Node& nodeAt(const Node* node) { return *node; }
+
+    // Appends the first n values of from to the end of to.
+    static void moveFront(Node& from, Node& to, const std::size_t n) {
+        std::move(from.values.begin(), from.values.begin() + n, to.values.begin() + to.size);
+        to.size += n;
+        std::move(from.values.begin() + n, from.values.begin() + from.size, from.values.begin());
+        std::fill(from.values.begin() + from.size - n, from.values.begin() + from.size, T{});
+        from.size -= n;
+    }
+
+    // Prepends the last n values of from to the front of to.
+    static void moveBack(Node& from, Node& to, const std::size_t n) {
+        std::move_backward(to.values.begin(), to.values.begin() + to.size, to.values.begin() + to.size + n);
+        std::move(from.values.begin() + from.size - n, from.values.begin() + from.size, to.values.begin());
+        to.size += n;
+        std::fill(from.values.begin() + from.size - n, from.values.begin() + from.size, T{});
+        from.size -= n;
+    }
+
+    // The bucket value belongs in: the one whose interval contains it, otherwise the bucket at
+    // which the descent falls off the tree, which is adjacent to the gap value lies in.
+    [[nodiscard]] Node* targetBucket(const T& value) const {
+        Node* node = root.get();
+        while (true) {
+            if (value < node->min()) {
+                AVL_COUNT(++counters.updateComparisons);
+                if (!node->left) return node;
+                node = node->left.get();
+            } else if (value > node->max()) {
+                AVL_COUNT(counters.updateComparisons += 2);
+                if (!node->right) return node;
+                node = node->right.get();
+            } else {
+                AVL_COUNT(counters.updateComparisons += 2);
+                return node;
+            }
+        }
+    }
+
+    [[nodiscard]] Node* containingBucket(const T& value) const {
+        Node* node = root.get();
+        while (node) {
+            if (value < node->min()) {
+                AVL_COUNT(++counters.searchComparisons);
+                node = node->left.get();
+            } else if (value > node->max()) {
+                AVL_COUNT(counters.searchComparisons += 2);
+                node = node->right.get();
+            } else {
+                AVL_COUNT(counters.searchComparisons += 2);
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] Node* successorOf(const Node& bucket) const {
+        Node* candidate = nullptr;
+        for (Node* node = root.get(); node;) {
+            if (bucket.max() < node->min()) {
+                candidate = node;
+                node = node->left.get();
+            } else {
+                node = node->right.get();
+            }
+        }
+        return candidate;
+    }
+
+    [[nodiscard]] Node* predecessorOf(const Node& bucket) const {
+        Node* candidate = nullptr;
+        for (Node* node = root.get(); node;) {
+            if (node->max() < bucket.min()) {
+                candidate = node;
+                node = node->right.get();
+            } else {
+                node = node->left.get();
+            }
+        }
+        return candidate;
+    }
+
+    std::unique_ptr<Node> insertBucket(std::unique_ptr<Node> node, std::unique_ptr<Node>& bucket) {
+        if (!node) {
+            ++buckets;
+            AVL_COUNT(++counters.allocations);
+            return std::move(bucket);
+        }
+
+        if (bucket->min() < node->min()) {
+            node->left = insertBucket(std::move(node->left), bucket);
+        } else {
+            node->right = insertBucket(std::move(node->right), bucket);
+        }
+        return balance(std::move(node));
+    }
+
+    std::pair<std::unique_ptr<Node>, std::unique_ptr<Node>> detachMin(std::unique_ptr<Node> node) {
+        if (!node->left) {
+            auto rest = std::move(node->right);
+            return {std::move(rest), std::move(node)};
+        }
+
+        auto [rest, min] = detachMin(std::move(node->left));
+        node->left = std::move(rest);
+        return {balance(std::move(node)), std::move(min)};
+    }
+
+    // Unlinks and frees target, located by a value that lies in its interval (or did, if
+    // target has already been emptied); intervals are disjoint, so the path is the same.
+    std::unique_ptr<Node> removeBucket(std::unique_ptr<Node> node, const T& value, const Node* target) {
+        if (node.get() == target) {
+            --buckets;
+            AVL_COUNT(++counters.frees);
+            if (!node->left) return std::move(node->right);
+            if (!node->right) return std::move(node->left);
+
+            auto [rest, successor] = detachMin(std::move(node->right));
+            successor->left = std::move(node->left);
+            successor->right = std::move(rest);
+            return balance(std::move(successor));
+        }
+
+        if (value < node->min()) {
+            node->left = removeBucket(std::move(node->left), value, target);
+        } else {
+            node->right = removeBucket(std::move(node->right), value, target);
+        }
+        return balance(std::move(node));
+    }
+
+    // Refills a bucket that fell below minFill from its successor, or its predecessor for the
+    // last bucket, merging the two when they fit into one.
+    void refill(Node& bucket) {
+        if (Node* next = successorOf(bucket)) {
+            if (bucket.size + next->size <= Capacity) {
+                const T located = next->min();
+                moveFront(*next, bucket, next->size);
+                root = removeBucket(std::move(root), located, next);
+            } else {
+                moveFront(*next, bucket, (next->size - bucket.size) / 2);
+            }
+        } else if (Node* previous = predecessorOf(bucket)) {
+            if (bucket.size + previous->size <= Capacity) {
+                const T located = bucket.min();
+                moveFront(bucket, *previous, bucket.size);
+                root = removeBucket(std::move(root), located, &bucket);
+            } else {
+                moveBack(*previous, bucket, (previous->size - bucket.size) / 2);
+            }
+        }
+    }
+
+    void inorderTraversal(const Node* node, auto& visitor) const {
+        if (!node) return;
+
+        inorderTraversal(node->left.get(), visitor);
+        for (std::size_t i = 0; i < node->size; ++i) visitor(node->values[i]);
+        inorderTraversal(node->right.get(), visitor);
+    }
+
+    void rangeTraversal(const Node* node, const T& low, const T& high, auto& visitor) const {
+        if (!node) return;
+
+        if (low < node->min()) {
+            rangeTraversal(node->left.get(), low, high, visitor);
+        }
+        for (std::size_t i = node->position(low); i < node->size && !(node->values[i] > high); ++i) {
+            visitor(node->values[i]);
+        }
+        if (high > node->max()) {
+            rangeTraversal(node->right.get(), low, high, visitor);
+        }
+    }
+
+public:
+    BucketedAVLTree() = default;
+
+    void insert(T value) {
+        AVL_TRACE_SCOPE(Insert);
+        if (!root) {
+            auto bucket = std::make_unique<Node>();
+            bucket->insertAt(0, std::move(value));
+            root = insertBucket(nullptr, bucket);
+            ++count;
+            return;
+        }
+
+        Node* bucket = targetBucket(value);
+        std::size_t index = bucket->position(value);
+        if (index < bucket->size && bucket->values[index] == value) return;
+
+        if (bucket->size == Capacity) {
+            auto upper = std::make_unique<Node>();
+            moveBack(*bucket, *upper, Capacity / 2);
+            if (!(value < upper->min())) {
+                bucket = upper.get();
+                index = upper->position(value);
+            }
+            root = insertBucket(std::move(root), upper);
+        }
+        bucket->insertAt(index, std::move(value));
+        ++count;
+        AVL_COUNT(finishUpdate());
+    }
+
+    void remove(const T& value) {
+        AVL_TRACE_SCOPE(Remove);
+        Node* bucket = containingBucket(value);
+        if (!bucket) return;
+
+        const std::size_t index = bucket->position(value);
+        if (!(bucket->values[index] == value)) return;
+
+        bucket->eraseAt(index);
+        --count;
+        if (bucket->size == 0) {
+            root = removeBucket(std::move(root), value, bucket);
+        } else if (bucket->size < minFill) {
+            refill(*bucket);
+        }
+        AVL_COUNT(finishUpdate());
+    }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    [[nodiscard]] std::size_t bucketCount() const { return buckets; }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        return find(value) != nullptr;
+    }
+
+    [[nodiscard]] const T* find(const T& value) const {
+        AVL_TRACE_SCOPE(Search);
+        AVL_COUNT(++counters.searches);
+        const Node* bucket = containingBucket(value);
+        if (!bucket) return nullptr;
+        const T& candidate = bucket->values[bucket->position(value)];
+        return candidate == value ? &candidate : nullptr;
+    }
+
+    // Smallest stored value that is not less than value, or nullptr.
+    [[nodiscard]] const T* lower_bound(const T& value) const {
+        const T* candidate = nullptr;
+        for (const Node* node = root.get(); node;) {
+            if (value > node->max()) {
+                node = node->right.get();
+            } else if (value < node->min()) {
+                candidate = &node->min();
+                node = node->left.get();
+            } else {
+                return &node->values[node->position(value)];
+            }
+        }
+        return candidate;
+    }
+
+    [[nodiscard]] std::optional<T> get(const T& value) const {
+        const T* found = find(value);
+        return found ? std::optional<T>(*found) : std::nullopt;
+    }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        inorderTraversal(root.get(), visitor);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        rangeTraversal(root.get(), low, high, visitor);
+    }
+
+    void print(std::ostream& os = std::cout) const {
+        os << "Tree structure (" << buckets << " buckets):" << std::endl;
+
+        auto labelFn = [this](const Node* node) -> std::string {
+            if (!node) return "";
+            std::stringstream ss;
+            ss << node->min() << ".." << node->max() << "(" << node->size << ")[" << balanceFactor(node) << "]";
+            return ss.str();
+        };
+
+        auto leftFn = [](const Node* node) -> const Node* {
+            return node ? node->left.get() : nullptr;
+        };
+
+        auto rightFn = [](const Node* node) -> const Node* {
+            return node ? node->right.get() : nullptr;
+        };
+
+        TreePrinter<T, Node> printer(labelFn, leftFn, rightFn, os);
+        printer.setSquareBranches(true);
+        printer.setHspace(3);
+        printer.printTree(root.get());
+
+        os << "\nInorder traversal: ";
+        inorder([&os](const T& value) { os << value << " "; });
+        os << std::endl;
+    }
+};
+
+#endif //BUCKETEDAVLTREE_H
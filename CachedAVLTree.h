@@ -0,0 +1,135 @@
+#ifndef CACHEDAVLTREE_H
+#define CACHEDAVLTREE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "AVLTree.h"
+
+struct LookupCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t invalidations = 0;
+
+    [[nodiscard]] double hitRate() const {
+        return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0;
+    }
+};
+
+// AVLTree with a small set-associative cache of found keys in front of the descent. Entries
+// point at the value inside its node; AVLTree never moves a stored value (rotations relink
+// nodes, remove relinks the successor node), so an entry only goes stale when its own key is
+// removed, and remove() drops it. Inserts and rotations therefore need no invalidation. Only
+// hits are cached: a cached miss would need invalidating on every insert.
+//
+// Each set keeps its ways in most-recently-used order and evicts the last one. Lookups update
+// the cache, so unlike a bare AVLTree concurrent contains() calls are not safe.
+template <Comparable T, std::size_t Sets = 256, std::size_t Ways = 4, typename Hash = std::hash<T>>
+class CachedAVLTree {
+    static_assert(Sets > 0 && (Sets & (Sets - 1)) == 0, "the number of sets must be a power of two");
+    static_assert(Ways > 0);
+
+    struct Entry {
+        std::uint64_t hash = 0;
+        const T* value = nullptr;
+    };
+
+    using Set = std::array<Entry, Ways>;
+
+    AVLTree<T> tree;
+    mutable std::vector<Set> sets = std::vector<Set>(Sets);
+    mutable LookupCacheStats cacheStats;
+    [[no_unique_address]] Hash hasher;
+
+    [[nodiscard]] std::uint64_t hashOf(const T& value) const {
+        return static_cast<std::uint64_t>(hasher(value)) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    [[nodiscard]] Set& setFor(const std::uint64_t hash) const {
+        return sets[(hash >> 32) & (Sets - 1)];
+    }
+
+    [[nodiscard]] const T* lookup(const T& value) const {
+        const std::uint64_t hash = hashOf(value);
+        Set& set = setFor(hash);
+
+        for (std::size_t way = 0; way < Ways; ++way) {
+            if (set[way].value && set[way].hash == hash && *set[way].value == value) {
+                ++cacheStats.hits;
+                std::rotate(set.begin(), set.begin() + way, set.begin() + way + 1);
+                return set[0].value;
+            }
+        }
+
+        ++cacheStats.misses;
+        const T* found = tree.find(value);
+        if (found) {
+            std::move_backward(set.begin(), set.end() - 1, set.end());
+            set[0] = {hash, found};
+        }
+        return found;
+    }
+
+public:
+    CachedAVLTree() = default;
+
+    CachedAVLTree(const CachedAVLTree&) = delete;
+    CachedAVLTree& operator=(const CachedAVLTree&) = delete;
+
+    void insert(T value) {
+        tree.insert(std::move(value));
+    }
+
+    void remove(const T& value) {
+        const std::uint64_t hash = hashOf(value);
+        Set& set = setFor(hash);
+        for (std::size_t way = 0; way < Ways; ++way) {
+            if (set[way].value && set[way].hash == hash && *set[way].value == value) {
+                std::move(set.begin() + way + 1, set.end(), set.begin() + way);
+                set[Ways - 1] = {};
+                ++cacheStats.invalidations;
+                break;
+            }
+        }
+        tree.remove(value);
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        return lookup(value) != nullptr;
+    }
+
+    [[nodiscard]] std::optional<T> get(const T& value) const {
+        const T* found = lookup(value);
+        return found ? std::optional<T>(*found) : std::nullopt;
+    }
+
+    [[nodiscard]] std::size_t size() const { return tree.size(); }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        tree.inorder(visitor);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        tree.range(low, high, visitor);
+    }
+
+    void print(std::ostream& os = std::cout) const {
+        tree.print(os);
+    }
+
+    [[nodiscard]] const AVLTree<T>& underlying() const { return tree; }
+
+    [[nodiscard]] const LookupCacheStats& cacheStatistics() const { return cacheStats; }
+
+    void resetCacheStatistics() { cacheStats = {}; }
+};
+
+#endif //CACHEDAVLTREE_H
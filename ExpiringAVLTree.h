@@ -0,0 +1,146 @@
+#ifndef EXPIRINGAVLTREE_H
+#define EXPIRINGAVLTREE_H
+
+#include <algorithm>
+#include <chrono>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "AVLTree.h"
+
+// AVLTree whose values expire ttl after their last insert. A second AVLTree orders the values
+// by (expiry, address); stored values never move (see AVLTree::find), so their address
+// identifies them. expire(now) cuts every expired entry out of that index with one
+// erase_range() and removes the values with one AVLTree::removeSorted() pass, instead of a
+// descent and retrace per value.
+//
+// With a non-zero lazyBudget, insert() also removes up to that many expired values, which keeps
+// the set close to its window without ever calling expire(), at a bounded cost per call.
+template <Comparable T, typename Clock = std::chrono::steady_clock>
+class ExpiringAVLTree {
+public:
+    using time_point = typename Clock::time_point;
+    using duration = typename Clock::duration;
+
+private:
+    struct Expiry {
+        time_point at;
+        std::uintptr_t address;
+
+        auto operator<=>(const Expiry&) const = default;
+    };
+
+    AVLTree<T> values;
+    AVLTree<Expiry> expiries;
+    std::unordered_map<const T*, time_point> expiryOf;
+    duration ttl;
+    std::size_t lazyBudget;
+
+    [[nodiscard]] static std::uintptr_t addressOf(const T* value) {
+        return reinterpret_cast<std::uintptr_t>(value);
+    }
+
+    // Removes the expired values, at most limit of them and the earliest expiries first.
+    void removeExpired(const time_point now, const std::size_t limit) {
+        static constexpr Expiry first{time_point::min(), 0};
+        std::vector<const T*> expired;
+        if (limit == std::numeric_limits<std::size_t>::max()) {
+            expiries.range(first, Expiry{now, std::numeric_limits<std::uintptr_t>::max()}, [&](const Expiry& e) {
+                expired.push_back(reinterpret_cast<const T*>(e.address));
+            });
+        } else {
+            for (const Expiry* next = expiries.lower_bound(first); next && next->at <= now && expired.size() < limit;
+                 next = expiries.lower_bound(Expiry{next->at, next->address + 1})) {
+                expired.push_back(reinterpret_cast<const T*>(next->address));
+            }
+        }
+        if (expired.empty()) return;
+
+        expiries.erase_range(first, Expiry{expiryOf.at(expired.back()), addressOf(expired.back())});
+        for (const T* value : expired) expiryOf.erase(value);
+
+        std::sort(expired.begin(), expired.end(), [](const T* a, const T* b) { return *a < *b; });
+        values.removeSorted(expired, [](const T* value) -> const T& { return *value; });
+    }
+
+public:
+    explicit ExpiringAVLTree(const duration ttl, const std::size_t lazyBudget = 0)
+        : ttl(ttl), lazyBudget(lazyBudget) {}
+
+    ExpiringAVLTree(const ExpiringAVLTree&) = delete;
+    ExpiringAVLTree& operator=(const ExpiringAVLTree&) = delete;
+
+    // Inserts value to expire at now + ttl, or moves the expiry of an equal stored value there.
+    const T* insert(T value, const time_point now) {
+        if (lazyBudget) removeExpired(now, lazyBudget);
+
+        const T* stored = values.insert(std::move(value));
+        const time_point at = now + ttl;
+        auto [entry, inserted] = expiryOf.try_emplace(stored, at);
+        if (!inserted) {
+            expiries.remove(Expiry{entry->second, addressOf(stored)});
+            entry->second = at;
+        }
+        expiries.insert(Expiry{at, addressOf(stored)});
+        return stored;
+    }
+
+    void remove(const T& value) {
+        const T* stored = values.find(value);
+        if (!stored) return;
+
+        const auto entry = expiryOf.find(stored);
+        expiries.remove(Expiry{entry->second, addressOf(stored)});
+        expiryOf.erase(entry);
+        values.remove(value);
+    }
+
+    // Removes every value whose expiry is not after now and returns how many there were.
+    std::size_t expire(const time_point now) {
+        const std::size_t before = values.size();
+        removeExpired(now, std::numeric_limits<std::size_t>::max());
+        return before - values.size();
+    }
+
+    [[nodiscard]] std::optional<time_point> expiresAt(const T& value) const {
+        const T* stored = values.find(value);
+        return stored ? std::optional(expiryOf.at(stored)) : std::nullopt;
+    }
+
+    // Earliest expiry of any stored value, e.g. to schedule the next expire() call.
+    [[nodiscard]] std::optional<time_point> nextExpiry() const {
+        const Expiry* first = expiries.lower_bound(Expiry{time_point::min(), 0});
+        return first ? std::optional(first->at) : std::nullopt;
+    }
+
+    [[nodiscard]] std::size_t size() const { return values.size(); }
+
+    [[nodiscard]] bool empty() const { return values.empty(); }
+
+    // Lookups do not check expiry: a value stays visible until expire() or a lazy insert
+    // removes it.
+    [[nodiscard]] bool contains(const T& value) const { return values.contains(value); }
+
+    [[nodiscard]] const T* find(const T& value) const { return values.find(value); }
+
+    [[nodiscard]] const T* lower_bound(const T& value) const { return values.lower_bound(value); }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        values.inorder(visitor);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        values.range(low, high, visitor);
+    }
+
+    [[nodiscard]] const AVLTree<T>& underlying() const { return values; }
+};
+
+#endif //EXPIRINGAVLTREE_H
@@ -0,0 +1,150 @@
+#ifndef FILTEREDAVLTREE_H
+#define FILTEREDAVLTREE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "AVLTree.h"
+
+// Bloom filter whose k probes for a key all land in one 64 byte block, so a query touches a
+// single cache line. About 10 bits per key with k = 8 gives roughly a 1% false positive rate.
+class BlockedBloomFilter {
+    struct alignas(64) Block {
+        std::array<std::uint64_t, 8> words{};
+    };
+
+    static constexpr int probes = 8;
+    static constexpr std::size_t bitsPerKey = 10;
+
+    std::vector<Block> blocks;
+
+    [[nodiscard]] static std::uint64_t mix(std::uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        return h ^ (h >> 33);
+    }
+
+    [[nodiscard]] std::size_t blockIndex(const std::uint64_t h) const {
+        return static_cast<std::size_t>((static_cast<unsigned __int128>(h) * blocks.size()) >> 64);
+    }
+
+public:
+    explicit BlockedBloomFilter(const std::size_t capacity = 0)
+        : blocks(std::max<std::size_t>(1, (capacity * bitsPerKey + 511) / 512)) {}
+
+    // Probe positions are 9 bit fields of a second hash; neighbouring fields overlap by two
+    // bits, which costs little accuracy and saves a third hash.
+    void add(const std::uint64_t hash) {
+        const std::uint64_t h = mix(hash);
+        Block& block = blocks[blockIndex(h)];
+        const std::uint64_t bits = h * 0x9e3779b97f4a7c15ULL;
+        for (int i = 0; i < probes; ++i) {
+            const unsigned bit = (bits >> (7 * i)) & 511;
+            block.words[bit >> 6] |= std::uint64_t{1} << (bit & 63);
+        }
+    }
+
+    [[nodiscard]] bool mayContain(const std::uint64_t hash) const {
+        const std::uint64_t h = mix(hash);
+        const Block& block = blocks[blockIndex(h)];
+        const std::uint64_t bits = h * 0x9e3779b97f4a7c15ULL;
+        for (int i = 0; i < probes; ++i) {
+            const unsigned bit = (bits >> (7 * i)) & 511;
+            if (!(block.words[bit >> 6] & (std::uint64_t{1} << (bit & 63)))) return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] std::size_t bytes() const { return blocks.size() * sizeof(Block); }
+};
+
+// AVLTree behind a blocked Bloom filter: lookups the filter rejects return without touching the
+// tree. A Bloom filter cannot delete, so removed keys stay in it as stale positives until the
+// next rebuild. The filter is rebuilt from the tree in O(n) when the tree outgrows it or when
+// the removals since the last rebuild reach half its capacity, which keeps both the size and
+// the stale share bounded at amortised O(1) per update.
+template <Comparable T, typename Hash = std::hash<T>>
+class FilteredAVLTree {
+    static constexpr std::size_t minCapacity = 1024;
+
+    AVLTree<T> tree;
+    BlockedBloomFilter filter{minCapacity};
+    std::size_t capacity = minCapacity;
+    std::size_t removalsSinceRebuild = 0;
+    mutable std::uint64_t lookups = 0;
+    mutable std::uint64_t rejected = 0;
+    [[no_unique_address]] Hash hash;
+
+    void rebuild() {
+        capacity = std::max(minCapacity, 2 * tree.size());
+        filter = BlockedBloomFilter(capacity);
+        tree.inorder([this](const T& value) { filter.add(hash(value)); });
+        removalsSinceRebuild = 0;
+    }
+
+    [[nodiscard]] bool filtered(const T& value) const {
+        ++lookups;
+        if (filter.mayContain(hash(value))) return false;
+        ++rejected;
+        return true;
+    }
+
+public:
+    FilteredAVLTree() = default;
+
+    void insert(T value) {
+        filter.add(hash(value));
+        tree.insert(std::move(value));
+        if (tree.size() > capacity) rebuild();
+    }
+
+    void remove(const T& value) {
+        const std::size_t before = tree.size();
+        tree.remove(value);
+        if (tree.size() != before && ++removalsSinceRebuild > capacity / 2) rebuild();
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        return !filtered(value) && tree.contains(value);
+    }
+
+    [[nodiscard]] std::optional<T> get(const T& value) const {
+        if (filtered(value)) return std::nullopt;
+        return tree.get(value);
+    }
+
+    [[nodiscard]] std::size_t size() const { return tree.size(); }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        tree.inorder(visitor);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        tree.range(low, high, visitor);
+    }
+
+    void print(std::ostream& os = std::cout) const {
+        tree.print(os);
+    }
+
+    [[nodiscard]] const AVLTree<T>& underlying() const { return tree; }
+
+    // Share of lookups answered by the filter alone.
+    [[nodiscard]] double filterRejectRate() const {
+        return lookups ? static_cast<double>(rejected) / static_cast<double>(lookups) : 0;
+    }
+
+    [[nodiscard]] std::size_t filterBytes() const { return filter.bytes(); }
+};
+
+#endif //FILTEREDAVLTREE_H
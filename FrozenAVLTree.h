@@ -0,0 +1,87 @@
+#ifndef FROZENAVLTREE_H
+#define FROZENAVLTREE_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+
+#include "AVLTree.h"
+
+// Read-only snapshot of an AVLTree in a flat array, meant to be built during constant
+// evaluation (see freezeAVLTree) and stored in a constexpr variable. The values sit in
+// breadth-first (Eytzinger) order, slot i having children 2i and 2i + 1, so the top levels of
+// every search share the first cache lines and the descent needs no pointers or branches.
+// T has to be a literal type that does not own heap memory, e.g. integers or std::string_view.
+template <Comparable T, std::size_t N>
+class FrozenAVLTree {
+    // 1-based, slots[0] is unused.
+    std::array<T, N + 1> slots{};
+
+    constexpr std::size_t place(const std::array<T, N>& sorted, std::size_t next, const std::size_t slot) {
+        if (slot > N) return next;
+
+        next = place(sorted, next, 2 * slot);
+        slots[slot] = sorted[next++];
+        return place(sorted, next, 2 * slot + 1);
+    }
+
+    template <typename Visitor>
+    constexpr void inorderTraversal(const std::size_t slot, Visitor& visitor) const {
+        if (slot > N) return;
+
+        inorderTraversal(2 * slot, visitor);
+        visitor(slots[slot]);
+        inorderTraversal(2 * slot + 1, visitor);
+    }
+
+public:
+    // tree must hold exactly N values.
+    constexpr explicit FrozenAVLTree(const AVLTree<T>& tree) {
+        std::array<T, N> sorted{};
+        std::size_t next = 0;
+        tree.inorder([&](const T& value) { sorted[next++] = value; });
+        place(sorted, 0, 1);
+    }
+
+    [[nodiscard]] static constexpr std::size_t size() { return N; }
+
+    [[nodiscard]] static constexpr bool empty() { return N == 0; }
+
+    // Descends to a leaf comparing once per level; the path's last right turn is then undone
+    // by dropping the trailing one bits of the slot index.
+    [[nodiscard]] constexpr const T* lower_bound(const T& value) const {
+        std::size_t slot = 1;
+        while (slot <= N) slot = 2 * slot + (slots[slot] < value);
+        slot >>= std::countr_one(slot) + 1;
+        return slot ? &slots[slot] : nullptr;
+    }
+
+    [[nodiscard]] constexpr const T* find(const T& value) const {
+        const T* candidate = lower_bound(value);
+        return candidate && *candidate == value ? candidate : nullptr;
+    }
+
+    [[nodiscard]] constexpr bool contains(const T& value) const { return find(value) != nullptr; }
+
+    template <typename Visitor>
+    constexpr void inorder(Visitor visitor) const {
+        inorderTraversal(1, visitor);
+    }
+};
+
+// Runs Build, a captureless lambda returning an AVLTree, at compile time and freezes the result:
+//
+//     static constexpr auto allowed = freezeAVLTree<[] {
+//         AVLTree<int> tree;
+//         for (const int code : {200, 204, 301, 404}) tree.insert(code);
+//         return tree;
+//     }>();
+//     static_assert(allowed.contains(404));
+template <auto Build>
+consteval auto freezeAVLTree() {
+    using Tree = decltype(Build());
+    constexpr std::size_t n = Build().size();
+    return FrozenAVLTree<typename Tree::value_type, n>(Build());
+}
+
+#endif //FROZENAVLTREE_H
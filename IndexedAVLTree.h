@@ -0,0 +1,204 @@
+#ifndef INDEXEDAVLTREE_H
+#define INDEXEDAVLTREE_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "AVLTree.h"
+
+// Open-addressing hash set of pointers to values that live elsewhere, laid out like a Swiss
+// table: one control byte per slot (empty, deleted, or 7 bits of the hash) scanned 16 at a
+// time with SSE2, so most probes compare a single group and dereference only real candidates.
+// Groups are visited in triangular order, which reaches every group of a power-of-two table.
+template <typename T, typename Hash = std::hash<T>>
+class FlatPointerIndex {
+    static constexpr std::size_t groupWidth = 16;
+    static constexpr std::int8_t emptyByte = -128;
+    static constexpr std::int8_t deletedByte = -2;
+
+    std::vector<std::int8_t> control = std::vector<std::int8_t>(groupWidth, emptyByte);
+    std::vector<const T*> slots = std::vector<const T*>(groupWidth, nullptr);
+    std::size_t used = 0;
+    std::size_t tombstones = 0;
+    [[no_unique_address]] Hash hasher;
+
+    [[nodiscard]] std::size_t groupMask() const { return control.size() / groupWidth - 1; }
+
+    [[nodiscard]] std::uint32_t matchByte(const std::size_t group, const std::int8_t byte) const {
+        const std::int8_t* bytes = control.data() + group * groupWidth;
+#if defined(__SSE2__)
+        const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(byte))));
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < groupWidth; ++i) mask |= static_cast<std::uint32_t>(bytes[i] == byte) << i;
+        return mask;
+#endif
+    }
+
+    // Empty and deleted are the only control bytes below -1.
+    [[nodiscard]] std::uint32_t matchFree(const std::size_t group) const {
+        const std::int8_t* bytes = control.data() + group * groupWidth;
+#if defined(__SSE2__)
+        const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl)));
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < groupWidth; ++i) mask |= static_cast<std::uint32_t>(bytes[i] < -1) << i;
+        return mask;
+#endif
+    }
+
+    [[nodiscard]] std::size_t slotOf(const T& value, const std::uint64_t hash) const {
+        const auto tag = static_cast<std::int8_t>(hash & 0x7f);
+        std::size_t group = (hash >> 7) & groupMask();
+        for (std::size_t step = 1; step <= groupMask() + 1; ++step) {
+            for (std::uint32_t mask = matchByte(group, tag); mask; mask &= mask - 1) {
+                const std::size_t slot = group * groupWidth + std::countr_zero(mask);
+                if (*slots[slot] == value) return slot;
+            }
+            if (matchByte(group, emptyByte)) break;
+            group = (group + step) & groupMask();
+        }
+        return slots.size();
+    }
+
+    void place(const std::uint64_t hash, const T* value) {
+        std::size_t group = (hash >> 7) & groupMask();
+        for (std::size_t step = 1;; ++step) {
+            if (const std::uint32_t mask = matchFree(group)) {
+                const std::size_t slot = group * groupWidth + std::countr_zero(mask);
+                if (control[slot] == deletedByte) --tombstones;
+                control[slot] = static_cast<std::int8_t>(hash & 0x7f);
+                slots[slot] = value;
+                ++used;
+                return;
+            }
+            group = (group + step) & groupMask();
+        }
+    }
+
+    void rehash(const std::size_t capacity) {
+        std::vector<const T*> old = std::move(slots);
+        control.assign(capacity, emptyByte);
+        slots.assign(capacity, nullptr);
+        used = 0;
+        tombstones = 0;
+        for (const T* value : old) {
+            if (value) place(hashOf(*value), value);
+        }
+    }
+
+public:
+    [[nodiscard]] std::uint64_t hashOf(const T& value) const {
+        std::uint64_t h = static_cast<std::uint64_t>(hasher(value));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        return h ^ (h >> 33);
+    }
+
+    [[nodiscard]] const T* find(const T& value, const std::uint64_t hash) const {
+        const std::size_t slot = slotOf(value, hash);
+        return slot < slots.size() ? slots[slot] : nullptr;
+    }
+
+    // The caller guarantees no equal value is indexed yet. Tombstones count toward the 7/8 load
+    // limit; a rehash at the same size clears them when they are the reason for it.
+    void insert(const std::uint64_t hash, const T* value) {
+        if ((used + tombstones + 1) * 8 > control.size() * 7) {
+            rehash((used + 1) * 2 * 8 > control.size() * 7 ? control.size() * 2 : control.size());
+        }
+        place(hash, value);
+    }
+
+    bool erase(const T& value, const std::uint64_t hash) {
+        const std::size_t slot = slotOf(value, hash);
+        if (slot == slots.size()) return false;
+        control[slot] = deletedByte;
+        slots[slot] = nullptr;
+        --used;
+        ++tombstones;
+        return true;
+    }
+
+    [[nodiscard]] std::size_t size() const { return used; }
+
+    [[nodiscard]] std::size_t bytes() const { return control.size() * (1 + sizeof(const T*)); }
+};
+
+// AVLTree plus a flat hash index from key to node value. Point lookups (contains, get, find)
+// are expected O(1) through the index; lower_bound, range and ordered iteration use the tree.
+// Index entries point at values inside tree nodes, which AVLTree never moves, so the two only
+// have to be kept in step on insert and remove.
+template <Comparable T, typename Hash = std::hash<T>>
+class IndexedAVLTree {
+    AVLTree<T> tree;
+    FlatPointerIndex<T, Hash> index;
+
+public:
+    IndexedAVLTree() = default;
+
+    IndexedAVLTree(const IndexedAVLTree&) = delete;
+    IndexedAVLTree& operator=(const IndexedAVLTree&) = delete;
+
+    void insert(T value) {
+        const std::uint64_t hash = index.hashOf(value);
+        if (index.find(value, hash)) return;
+        index.insert(hash, tree.insert(std::move(value)));
+    }
+
+    // The index entry is dropped first because it still dereferences the node's value.
+    void remove(const T& value) {
+        if (index.erase(value, index.hashOf(value))) {
+            tree.remove(value);
+        }
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        return index.find(value, index.hashOf(value)) != nullptr;
+    }
+
+    [[nodiscard]] const T* find(const T& value) const {
+        return index.find(value, index.hashOf(value));
+    }
+
+    [[nodiscard]] std::optional<T> get(const T& value) const {
+        const T* found = find(value);
+        return found ? std::optional<T>(*found) : std::nullopt;
+    }
+
+    [[nodiscard]] const T* lower_bound(const T& value) const {
+        return tree.lower_bound(value);
+    }
+
+    [[nodiscard]] std::size_t size() const { return tree.size(); }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        tree.inorder(visitor);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        tree.range(low, high, visitor);
+    }
+
+    void print(std::ostream& os = std::cout) const {
+        tree.print(os);
+    }
+
+    [[nodiscard]] const AVLTree<T>& underlying() const { return tree; }
+
+    [[nodiscard]] std::size_t indexBytes() const { return index.bytes(); }
+};
+
+#endif //INDEXEDAVLTREE_H
@@ -0,0 +1,100 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// HDR-style histogram over nanoseconds: values below 16 get their own bucket, above that every
+// power of two is split into 16 linear sub-buckets, so any recorded value is reported within
+// about 6% while the whole 64 bit range needs under a thousand buckets.
+//
+// record() is meant for a single writing thread. Buckets are atomics so other threads can merge
+// a snapshot at any time without a data race; the writer uses plain load/store pairs, which
+// stay cheap because no other thread ever writes.
+class LatencyHistogram {
+public:
+    static constexpr int subBucketBits = 4;
+    static constexpr std::size_t subBuckets = std::size_t{1} << subBucketBits;
+    static constexpr std::size_t bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram& other) { merge(other); }
+
+    LatencyHistogram& operator=(const LatencyHistogram& other) {
+        if (this != &other) {
+            reset();
+            merge(other);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] static std::size_t bucketIndex(const std::uint64_t value) {
+        if (value < subBuckets) return static_cast<std::size_t>(value);
+        const int exponent = std::bit_width(value) - 1;
+        const std::size_t sub = (value >> (exponent - subBucketBits)) & (subBuckets - 1);
+        return static_cast<std::size_t>(exponent - subBucketBits + 1) * subBuckets + sub;
+    }
+
+    // Largest value that lands in the bucket, the same convention HdrHistogram reports.
+    [[nodiscard]] static std::uint64_t bucketUpperBound(const std::size_t index) {
+        if (index < subBuckets) return index;
+        const int exponent = static_cast<int>(index / subBuckets) + subBucketBits - 1;
+        const std::uint64_t sub = index % subBuckets;
+        const std::uint64_t width = std::uint64_t{1} << (exponent - subBucketBits);
+        return ((subBuckets + sub) << (exponent - subBucketBits)) + width - 1;
+    }
+
+    void record(const std::uint64_t value) {
+        auto& bucket = buckets[bucketIndex(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < bucketCount; ++i) {
+            if (const std::uint64_t n = other.buckets[i].load(std::memory_order_relaxed)) {
+                buckets[i].fetch_add(n, std::memory_order_relaxed);
+            }
+        }
+        total.fetch_add(other.total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t count() const { return total.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] std::uint64_t percentile(const double p) const {
+        std::uint64_t seen = 0;
+        std::uint64_t all = 0;
+        for (const auto& bucket : buckets) all += bucket.load(std::memory_order_relaxed);
+        if (all == 0) return 0;
+
+        const auto target = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(p * static_cast<double>(all) + 0.5));
+        for (std::size_t i = 0; i < bucketCount; ++i) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target) return bucketUpperBound(i);
+        }
+        return bucketUpperBound(bucketCount - 1);
+    }
+
+    [[nodiscard]] std::uint64_t max() const {
+        for (std::size_t i = bucketCount; i-- > 0;) {
+            if (buckets[i].load(std::memory_order_relaxed)) return bucketUpperBound(i);
+        }
+        return 0;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, bucketCount> buckets{};
+    std::atomic<std::uint64_t> total{0};
+};
+
+#endif //LATENCYHISTOGRAM_H
@@ -0,0 +1,197 @@
+#ifndef LATENCYRECORDINGAVLTREE_H
+#define LATENCYRECORDINGAVLTREE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "AVLTree.h"
+#include "LatencyHistogram.h"
+
+enum class LatencyOp : std::uint8_t { Insert, Remove, Contains, Get };
+
+struct LatencySummary {
+    std::uint64_t samples = 0;
+    std::uint64_t p50 = 0;
+    std::uint64_t p99 = 0;
+    std::uint64_t p999 = 0;
+    std::uint64_t max = 0;
+};
+
+// AVLTree with per-operation latency histograms. Every thread records into its own set of
+// histograms, which are merged only when someone asks for a summary, so recording never
+// contends. With sampleEvery = N only every Nth call of a thread reads the clock.
+//
+// The wrapper adds no locking: concurrent writers still need external synchronisation, the
+// same as for a bare AVLTree.
+template <Comparable T>
+class LatencyRecordingAVLTree {
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t opCount = 4;
+
+    struct ThreadHistograms {
+        std::array<LatencyHistogram, opCount> histograms;
+        std::uint64_t calls = 0;
+    };
+
+    class ScopedSample {
+        LatencyHistogram* histogram;
+        Clock::time_point start;
+
+    public:
+        explicit ScopedSample(LatencyHistogram* histogram)
+            : histogram(histogram), start(histogram ? Clock::now() : Clock::time_point{}) {}
+
+        ScopedSample(const ScopedSample&) = delete;
+        ScopedSample& operator=(const ScopedSample&) = delete;
+
+        ~ScopedSample() {
+            if (histogram) {
+                histogram->record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+            }
+        }
+    };
+
+    static std::uint64_t nextId() {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // Ids of the trees that are still alive. A thread prunes the entries of destroyed trees from
+    // its lookup map before it registers with another tree, if any tree died since its last
+    // prune, so the map holds about one entry per live tree the thread has used.
+    struct LiveTrees {
+        std::mutex mutex;
+        std::unordered_set<std::uint64_t> ids;
+        std::atomic<std::uint64_t> destroyed{0};
+    };
+
+    static LiveTrees& liveTrees() {
+        static LiveTrees live;
+        return live;
+    }
+
+    AVLTree<T> tree;
+    std::uint64_t sampleEvery;
+    // Ids instead of addresses key the thread-local lookup, so a new tree at a recycled address
+    // never picks up a dead tree's histograms.
+    std::uint64_t id = nextId();
+    mutable std::mutex registryMutex;
+    mutable std::vector<std::unique_ptr<ThreadHistograms>> threads;
+
+    ThreadHistograms& local() const {
+        thread_local std::uint64_t lastId = 0;
+        thread_local ThreadHistograms* last = nullptr;
+        if (lastId == id) return *last;
+
+        thread_local std::unordered_map<std::uint64_t, ThreadHistograms*> known;
+        thread_local std::uint64_t prunedAt = 0;
+        auto it = known.find(id);
+        if (it == known.end()) {
+            LiveTrees& live = liveTrees();
+            if (const std::uint64_t destroyed = live.destroyed.load(std::memory_order_acquire); destroyed != prunedAt) {
+                std::lock_guard lock(live.mutex);
+                std::erase_if(known, [&live](const auto& entry) { return !live.ids.contains(entry.first); });
+                prunedAt = destroyed;
+            }
+
+            std::lock_guard lock(registryMutex);
+            threads.push_back(std::make_unique<ThreadHistograms>());
+            it = known.emplace(id, threads.back().get()).first;
+        }
+
+        lastId = id;
+        last = it->second;
+        return *last;
+    }
+
+    [[nodiscard]] LatencyHistogram* sample(const LatencyOp op) const {
+        ThreadHistograms& state = local();
+        if (state.calls++ % sampleEvery != 0) return nullptr;
+        return &state.histograms[static_cast<std::size_t>(op)];
+    }
+
+public:
+    explicit LatencyRecordingAVLTree(const std::uint64_t sampleEvery = 1) : sampleEvery(std::max<std::uint64_t>(1, sampleEvery)) {
+        LiveTrees& live = liveTrees();
+        std::lock_guard lock(live.mutex);
+        live.ids.insert(id);
+    }
+
+    ~LatencyRecordingAVLTree() {
+        LiveTrees& live = liveTrees();
+        std::lock_guard lock(live.mutex);
+        live.ids.erase(id);
+        live.destroyed.fetch_add(1, std::memory_order_release);
+    }
+
+    LatencyRecordingAVLTree(const LatencyRecordingAVLTree&) = delete;
+    LatencyRecordingAVLTree& operator=(const LatencyRecordingAVLTree&) = delete;
+
+    void insert(T value) {
+        ScopedSample timer(sample(LatencyOp::Insert));
+        tree.insert(std::move(value));
+    }
+
+    void remove(const T& value) {
+        ScopedSample timer(sample(LatencyOp::Remove));
+        tree.remove(value);
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        ScopedSample timer(sample(LatencyOp::Contains));
+        return tree.contains(value);
+    }
+
+    [[nodiscard]] std::optional<T> get(const T& value) const {
+        ScopedSample timer(sample(LatencyOp::Get));
+        return tree.get(value);
+    }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        tree.inorder(visitor);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        tree.range(low, high, visitor);
+    }
+
+    void print(std::ostream& os = std::cout) const {
+        tree.print(os);
+    }
+
+    [[nodiscard]] const AVLTree<T>& underlying() const { return tree; }
+
+    [[nodiscard]] LatencyHistogram histogram(const LatencyOp op) const {
+        LatencyHistogram merged;
+        std::lock_guard lock(registryMutex);
+        for (const auto& thread : threads) {
+            merged.merge(thread->histograms[static_cast<std::size_t>(op)]);
+        }
+        return merged;
+    }
+
+    [[nodiscard]] LatencySummary latency(const LatencyOp op) const {
+        const LatencyHistogram merged = histogram(op);
+        return {merged.count(), merged.percentile(0.50), merged.percentile(0.99), merged.percentile(0.999), merged.max()};
+    }
+
+    void resetLatencies() {
+        std::lock_guard lock(registryMutex);
+        for (const auto& thread : threads) {
+            for (auto& h : thread->histograms) h.reset();
+        }
+    }
+};
+
+#endif //LATENCYRECORDINGAVLTREE_H
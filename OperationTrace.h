@@ -0,0 +1,199 @@
+#ifndef OPERATIONTRACE_H
+#define OPERATIONTRACE_H
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AVLTree.h"
+
+// Trace layout: the 4 byte magic "AVLT", a version byte and a key kind byte, followed by one
+// record per call: an op byte and the key. Integer keys are zigzag varints, string keys a
+// varint length followed by the bytes.
+
+enum class TraceOp : std::uint8_t { Insert, Remove, Contains, Get };
+
+enum class TraceKeyKind : std::uint8_t { Integer = 'i', String = 's' };
+
+template <typename T>
+struct TraceKeyCodec;
+
+template <std::signed_integral T>
+struct TraceKeyCodec<T> {
+    static constexpr TraceKeyKind kind = TraceKeyKind::Integer;
+
+    static std::uint64_t zigzag(const T value) {
+        const auto v = static_cast<std::int64_t>(value);
+        return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+
+    static T unzigzag(const std::uint64_t value) {
+        return static_cast<T>(static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1));
+    }
+};
+
+template <>
+struct TraceKeyCodec<std::string> {
+    static constexpr TraceKeyKind kind = TraceKeyKind::String;
+};
+
+class TraceWriter {
+    static constexpr std::size_t bufferSize = 1 << 16;
+
+    std::ofstream out;
+    std::vector<char> buffer;
+
+    void put(const char byte) {
+        buffer.push_back(byte);
+        if (buffer.size() >= bufferSize) flush();
+    }
+
+    void putVarint(std::uint64_t value) {
+        while (value >= 0x80) {
+            put(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        put(static_cast<char>(value));
+    }
+
+public:
+    TraceWriter(const std::string& path, const TraceKeyKind kind) : out(path, std::ios::binary | std::ios::trunc) {
+        if (!out) throw std::runtime_error("cannot open trace file " + path);
+        buffer.reserve(bufferSize);
+        for (const char c : {'A', 'V', 'L', 'T', static_cast<char>(1), static_cast<char>(kind)}) put(c);
+    }
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    ~TraceWriter() { flush(); }
+
+    template <std::signed_integral T>
+    void record(const TraceOp op, const T key) {
+        put(static_cast<char>(op));
+        putVarint(TraceKeyCodec<T>::zigzag(key));
+    }
+
+    void record(const TraceOp op, const std::string& key) {
+        put(static_cast<char>(op));
+        putVarint(key.size());
+        for (const char c : key) put(c);
+    }
+
+    void flush() {
+        if (buffer.empty()) return;
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.flush();
+        buffer.clear();
+    }
+};
+
+class TraceReader {
+    std::ifstream in;
+    TraceKeyKind keyKind;
+
+    [[nodiscard]] std::uint64_t getVarint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const int c = in.get();
+            if (c == std::char_traits<char>::eof()) throw std::runtime_error("trace ends inside a key");
+            value |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+            if (!(c & 0x80)) return value;
+        }
+        throw std::runtime_error("malformed varint in trace");
+    }
+
+public:
+    explicit TraceReader(const std::string& path) : in(path, std::ios::binary) {
+        if (!in) throw std::runtime_error("cannot open trace file " + path);
+
+        std::array<char, 6> header{};
+        in.read(header.data(), header.size());
+        if (!in || std::memcmp(header.data(), "AVLT", 4) != 0) throw std::runtime_error(path + " is not an operation trace");
+        if (header[4] != 1) throw std::runtime_error("unsupported trace version in " + path);
+
+        keyKind = static_cast<TraceKeyKind>(header[5]);
+        if (keyKind != TraceKeyKind::Integer && keyKind != TraceKeyKind::String) {
+            throw std::runtime_error("unknown key kind in " + path);
+        }
+    }
+
+    [[nodiscard]] TraceKeyKind kind() const { return keyKind; }
+
+    // Returns false at the end of the trace.
+    template <typename T>
+    bool next(TraceOp& op, T& key) {
+        if (TraceKeyCodec<T>::kind != keyKind) throw std::logic_error("trace key kind does not match the requested type");
+
+        const int c = in.get();
+        if (c == std::char_traits<char>::eof()) return false;
+        if (c > static_cast<int>(TraceOp::Get)) throw std::runtime_error("unknown op in trace");
+        op = static_cast<TraceOp>(c);
+
+        const std::uint64_t value = getVarint();
+        if constexpr (std::same_as<T, std::string>) {
+            key.resize(value);
+            in.read(key.data(), static_cast<std::streamsize>(value));
+            if (!in) throw std::runtime_error("trace ends inside a key");
+        } else {
+            key = TraceKeyCodec<T>::unzigzag(value);
+        }
+        return true;
+    }
+};
+
+// Drop-in replacement for AVLTree that appends every insert, remove, contains and get call to
+// a trace before forwarding it.
+template <Comparable T>
+class RecordingAVLTree {
+    AVLTree<T> tree;
+    TraceWriter& writer;
+
+public:
+    explicit RecordingAVLTree(TraceWriter& writer) : writer(writer) {}
+
+    void insert(T value) {
+        writer.record(TraceOp::Insert, value);
+        tree.insert(std::move(value));
+    }
+
+    void remove(const T& value) {
+        writer.record(TraceOp::Remove, value);
+        tree.remove(value);
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        writer.record(TraceOp::Contains, value);
+        return tree.contains(value);
+    }
+
+    [[nodiscard]] std::optional<T> get(const T& value) const {
+        writer.record(TraceOp::Get, value);
+        return tree.get(value);
+    }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        tree.inorder(visitor);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        tree.range(low, high, visitor);
+    }
+
+    void print(std::ostream& os = std::cout) const {
+        tree.print(os);
+    }
+
+    [[nodiscard]] const AVLTree<T>& underlying() const { return tree; }
+};
+
+#endif //OPERATIONTRACE_H
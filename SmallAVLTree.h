@@ -0,0 +1,364 @@
+#ifndef SMALLAVLTREE_H
+#define SMALLAVLTREE_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "AVLTree.h"
+
+// AVLTree with a small-buffer mode: up to InlineCapacity values live in a sorted array inside
+// the object, so tiny sets cost no heap node at all. The insert that would overflow the array
+// promotes every value into the node tree; removals that shrink the tree below half the inline
+// capacity demote it back. The gap between the two thresholds keeps a set that hovers around
+// InlineCapacity from converting on every operation.
+//
+// A separate class rather than a mode of AVLTree, so AVLTree itself stays as it is. The API
+// matches AVLTree's except that:
+// - pointers from insert(), find(), lower_bound() and the neighbour queries are only valid
+//   until the next change, since inline values shift and conversions move them;
+// - operation counters, parallel clone() and stats() cover the node tree only, and stats()
+//   is all zero while the values are inline.
+template <Comparable T, std::size_t InlineCapacity = 16>
+class SmallAVLTree {
+    static_assert(InlineCapacity >= 2, "inline capacity must hold at least two values");
+
+    static constexpr std::size_t demoteThreshold = InlineCapacity / 2;
+
+    alignas(T) std::byte storage[InlineCapacity * sizeof(T)];
+    std::size_t inlineCount = 0;
+    bool promoted = false;
+    AVLTree<T> tree;
+
+    [[nodiscard]] T* values() { return std::launder(reinterpret_cast<T*>(storage)); }
+
+    [[nodiscard]] const T* values() const { return std::launder(reinterpret_cast<const T*>(storage)); }
+
+    // Index of the first value not less than value. For arithmetic types the branch-free count
+    // gets vectorized; other types stop at the first match.
+    [[nodiscard]] std::size_t position(const T& value) const {
+        const T* data = values();
+        if constexpr (std::is_arithmetic_v<T>) {
+            std::size_t index = 0;
+            for (std::size_t i = 0; i < inlineCount; ++i) index += data[i] < value;
+            return index;
+        } else {
+            std::size_t index = 0;
+            while (index < inlineCount && data[index] < value) ++index;
+            return index;
+        }
+    }
+
+    // Index of the first value greater than value.
+    [[nodiscard]] std::size_t upperPosition(const T& value) const {
+        const std::size_t index = position(value);
+        return index < inlineCount && values()[index] == value ? index + 1 : index;
+    }
+
+    [[nodiscard]] const T* inlineAt(const std::size_t index) const {
+        return index < inlineCount ? values() + index : nullptr;
+    }
+
+    [[nodiscard]] const T* inlineFind(const T& value) const {
+        const std::size_t index = position(value);
+        return index < inlineCount && values()[index] == value ? values() + index : nullptr;
+    }
+
+    void destroyInline() {
+        std::destroy_n(values(), inlineCount);
+        inlineCount = 0;
+    }
+
+    // Removes the inline values in [first, last) and returns how many there were.
+    std::size_t eraseInline(const std::size_t first, const std::size_t last) {
+        if (first == last) return 0; // Moving the tail onto itself would empty strings.
+
+        T* data = values();
+        std::move(data + last, data + inlineCount, data + first);
+        std::destroy(data + inlineCount - (last - first), data + inlineCount);
+        inlineCount -= last - first;
+        return last - first;
+    }
+
+    // Leaves the values of other here and other empty and inline. Expects this to be empty.
+    void take(SmallAVLTree& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        promoted = std::exchange(other.promoted, false);
+        tree = std::move(other.tree);
+        std::uninitialized_move_n(other.values(), other.inlineCount, values());
+        inlineCount = other.inlineCount;
+        other.destroyInline();
+    }
+
+    void promote() {
+        for (std::size_t i = 0; i < inlineCount; ++i) tree.insert(std::move(values()[i]));
+        destroyInline();
+        promoted = true;
+    }
+
+    void demote() {
+        tree.inorder([this](const T& value) { std::construct_at(values() + inlineCount++, value); });
+        tree = AVLTree<T>();
+        promoted = false;
+    }
+
+    // Demotes a promoted tree that has shrunk below the threshold; returns removed.
+    std::size_t shrunk(const std::size_t removed) {
+        if (promoted && tree.size() < demoteThreshold) demote();
+        return removed;
+    }
+
+public:
+    using value_type = T;
+
+    SmallAVLTree() = default;
+
+    SmallAVLTree(const SmallAVLTree& other) : promoted(other.promoted), tree(other.tree) {
+        std::uninitialized_copy_n(other.values(), other.inlineCount, values());
+        inlineCount = other.inlineCount;
+    }
+
+    SmallAVLTree(SmallAVLTree&& other) noexcept(std::is_nothrow_move_constructible_v<T>) { take(other); }
+
+    SmallAVLTree& operator=(const SmallAVLTree& other) {
+        if (this != &other) SmallAVLTree(other).swap(*this);
+        return *this;
+    }
+
+    SmallAVLTree& operator=(SmallAVLTree&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~SmallAVLTree() { destroyInline(); }
+
+    // Inline values have to be moved, so unlike AVLTree::swap this is O(InlineCapacity).
+    void swap(SmallAVLTree& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        SmallAVLTree moved(std::move(other));
+        other = std::move(*this);
+        *this = std::move(moved);
+    }
+
+    friend void swap(SmallAVLTree& a, SmallAVLTree& b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+    // Copies a promoted tree on up to threads threads, see AVLTree::clone().
+    template <typename Spawn>
+    [[nodiscard]] SmallAVLTree clone(const std::size_t threads, Spawn spawn) const {
+        if (!promoted) return *this;
+
+        SmallAVLTree copy;
+        copy.tree = tree.clone(threads, std::move(spawn));
+        copy.promoted = true;
+        return copy;
+    }
+
+    // Builds a set from strictly increasing values in O(n).
+    [[nodiscard]] static SmallAVLTree fromSorted(std::vector<T> sorted) {
+        SmallAVLTree set;
+        if (sorted.size() > InlineCapacity) {
+            set.tree = AVLTree<T>::fromSorted(std::move(sorted));
+            set.promoted = true;
+        } else {
+            std::uninitialized_move(sorted.begin(), sorted.end(), set.values());
+            set.inlineCount = sorted.size();
+        }
+        return set;
+    }
+
+    // Returns the stored value, the existing one if an equal value was already present.
+    const T* insert(T value) {
+        if (promoted) return tree.insert(std::move(value));
+
+        const std::size_t index = position(value);
+        if (index < inlineCount && values()[index] == value) return values() + index;
+
+        if (inlineCount == InlineCapacity) {
+            promote();
+            return tree.insert(std::move(value));
+        }
+
+        T* data = values();
+        if (index == inlineCount) {
+            std::construct_at(data + inlineCount, std::move(value));
+        } else {
+            std::construct_at(data + inlineCount, std::move(data[inlineCount - 1]));
+            std::move_backward(data + index, data + inlineCount - 1, data + inlineCount);
+            data[index] = std::move(value);
+        }
+        ++inlineCount;
+        return data + index;
+    }
+
+    void remove(const T& value) {
+        if (promoted) {
+            tree.remove(value);
+            shrunk(0);
+            return;
+        }
+
+        const std::size_t index = position(value);
+        if (index < inlineCount && values()[index] == value) eraseInline(index, index + 1);
+    }
+
+    void clear() {
+        destroyInline();
+        tree.clear();
+        promoted = false;
+    }
+
+    // Hands a promoted tree's nodes to reclaimer, see AVLTree::clear(reclaimer).
+    template <std::same_as<AVLReclaimer> Reclaimer>
+    void clear(Reclaimer& reclaimer) {
+        destroyInline();
+        tree.clear(reclaimer);
+        promoted = false;
+    }
+
+    // Removes every value in [low, high] and returns how many there were.
+    std::size_t erase_range(const T& low, const T& high) {
+        if (promoted) return shrunk(tree.erase_range(low, high));
+        if (high < low) return 0;
+        return eraseInline(position(low), upperPosition(high));
+    }
+
+    // Removes every value less than value.
+    std::size_t erase_below(const T& value) {
+        if (promoted) return shrunk(tree.erase_below(value));
+        return eraseInline(0, position(value));
+    }
+
+    // Removes every value greater than value.
+    std::size_t erase_above(const T& value) {
+        if (promoted) return shrunk(tree.erase_above(value));
+        return eraseInline(upperPosition(value), inlineCount);
+    }
+
+    // Removes the values of sorted, strictly increasing after applying proj, and returns how
+    // many were present; see AVLTree::removeSorted().
+    template <std::ranges::random_access_range Range, typename Proj = std::identity>
+    std::size_t removeSorted(const Range& sorted, Proj proj = {}) {
+        if (promoted) return shrunk(tree.removeSorted(sorted, proj));
+
+        const std::size_t before = inlineCount;
+        for (const auto& value : sorted) remove(std::invoke(proj, value));
+        return before - inlineCount;
+    }
+
+    [[nodiscard]] std::size_t size() const { return promoted ? tree.size() : inlineCount; }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    // True while the values are kept in the inline array.
+    [[nodiscard]] bool isInline() const { return !promoted; }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        return promoted ? tree.contains(value) : inlineFind(value) != nullptr;
+    }
+
+    [[nodiscard]] const T* find(const T& value) const {
+        return promoted ? tree.find(value) : inlineFind(value);
+    }
+
+    [[nodiscard]] const T* lower_bound(const T& value) const {
+        if (promoted) return tree.lower_bound(value);
+        const std::size_t index = position(value);
+        return index < inlineCount ? values() + index : nullptr;
+    }
+
+    // Largest stored value less than value, or nullptr.
+    [[nodiscard]] const T* predecessor(const T& value) const {
+        if (promoted) return tree.predecessor(value);
+        const std::size_t index = position(value);
+        return index ? values() + index - 1 : nullptr;
+    }
+
+    // Smallest stored value greater than value, or nullptr.
+    [[nodiscard]] const T* successor(const T& value) const {
+        return promoted ? tree.successor(value) : inlineAt(upperPosition(value));
+    }
+
+    // Largest stored value not greater than value, or nullptr.
+    [[nodiscard]] const T* floor(const T& value) const {
+        if (promoted) return tree.floor(value);
+        const std::size_t index = upperPosition(value);
+        return index ? values() + index - 1 : nullptr;
+    }
+
+    // Smallest stored value not less than value, or nullptr; same as lower_bound().
+    [[nodiscard]] const T* ceiling(const T& value) const { return lower_bound(value); }
+
+    // The k stored values closest to value, nearest first and ties to the smaller value; see
+    // AVLTree::nearest(). Inline, the two candidates walk outward from position(value).
+    template <typename Distance = AVLAbsoluteDifference>
+    [[nodiscard]] std::vector<const T*> nearest(const T& value, const std::size_t k, Distance distance = {}) const {
+        if (promoted) return tree.nearest(value, k, distance);
+
+        const T* data = values();
+        std::size_t below = position(value);
+        std::size_t above = below;
+        std::vector<const T*> result;
+        result.reserve(std::min(k, inlineCount));
+        while (result.size() < k && (below > 0 || above < inlineCount)) {
+            const bool takeBelow = above == inlineCount ||
+                                   (below > 0 && !(distance(value, data[above]) < distance(value, data[below - 1])));
+            result.push_back(takeBelow ? data + --below : data + above++);
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::optional<T> get(const T& value) const {
+        const T* found = find(value);
+        return found ? std::optional<T>(*found) : std::nullopt;
+    }
+
+    // Statistics of the node tree; all zero while the values are inline.
+    [[nodiscard]] AVLTreeStats stats() const { return tree.stats(); }
+
+    // Counters of the node tree; inline operations are not counted.
+    static constexpr bool countersEnabled = AVLTree<T>::countersEnabled;
+
+    [[nodiscard]] AVLOperationCounters operationCounters() const { return tree.operationCounters(); }
+
+    void resetCounters() { tree.resetCounters(); }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        if (promoted) {
+            tree.inorder(visitor);
+            return;
+        }
+        for (std::size_t i = 0; i < inlineCount; ++i) visitor(values()[i]);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        if (promoted) {
+            tree.range(low, high, visitor);
+            return;
+        }
+        for (std::size_t i = position(low); i < inlineCount && !(high < values()[i]); ++i) visitor(values()[i]);
+    }
+
+    void print(std::ostream& os = std::cout) const {
+        if (promoted) {
+            tree.print(os);
+            return;
+        }
+        os << "Inline array (" << inlineCount << "/" << InlineCapacity << "): ";
+        inorder([&os](const T& value) { os << value << " "; });
+        os << std::endl;
+    }
+};
+
+#endif //SMALLAVLTREE_H
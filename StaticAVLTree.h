@@ -0,0 +1,325 @@
+#ifndef STATICAVLTREE_H
+#define STATICAVLTREE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "AVLBalance.h"
+#include "AVLTree.h"
+#include "TreePrinter.h"
+
+enum class AVLInsertStatus {
+    Inserted,
+    AlreadyPresent,
+    Full,
+};
+
+inline std::ostream& operator<<(std::ostream& os, const AVLInsertStatus status) {
+    switch (status) {
+        case AVLInsertStatus::Inserted: return os << "inserted";
+        case AVLInsertStatus::AlreadyPresent: return os << "already present";
+        case AVLInsertStatus::Full: return os << "full";
+    }
+    return os;
+}
+
+// AVL tree over a fixed array of Capacity nodes inside the object: no operation allocates, so
+// it can be used where make_unique is not allowed. Links are array indices with 0 as null, the
+// smallest integer type that fits Capacity. Freed slots are chained through their left link and
+// reused before untouched ones. Balancing is the same code as AVLTree's (AVLBalance.h).
+//
+// Values never move once inserted, so find() pointers stay valid until that value is removed.
+template <Comparable T, std::size_t Capacity>
+class StaticAVLTree : public AVLBalance<StaticAVLTree<T, Capacity>> {
+    static_assert(Capacity > 0, "capacity must be positive");
+
+    using Index = std::conditional_t<Capacity < std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+                                     std::uint32_t>;
+
+    struct Node {
+        Index left = 0;
+        Index right = 0;
+        int height = 0;
+    };
+
+    // Slot 0 is the null link, so node i owns values()[i - 1].
+    std::array<Node, Capacity + 1> nodes{};
+    alignas(T) std::byte storage[Capacity * sizeof(T)];
+    Index root = 0;
+    Index freeList = 0;
+    Index untouched = 1;
+    std::size_t count = 0;
+
+    friend AVLBalance<StaticAVLTree>;
+
+    using AVLBalance<StaticAVLTree>::height;
+    using AVLBalance<StaticAVLTree>::balanceFactor;
+    using AVLBalance<StaticAVLTree>::balance;
+#ifdef AVL_TREE_STATS
+    using AVLBalance<StaticAVLTree>::counters;
+    using AVLBalance<StaticAVLTree>::finishUpdate;
+#endif
+
+    [[nodiscard]] Node& nodeAt(const Index index) { return nodes[index]; }
+
+    [[nodiscard]] const Node& nodeAt(const Index index) const { return nodes[index]; }
+
+    [[nodiscard]] T& valueAt(const Index index) {
+        return std::launder(reinterpret_cast<T*>(storage))[index - 1];
+    }
+
+    [[nodiscard]] const T& valueAt(const Index index) const {
+        return std::launder(reinterpret_cast<const T*>(storage))[index - 1];
+    }
+
+    [[nodiscard]] Index allocate(T& value) {
+        Index index = freeList;
+        if (index) {
+            freeList = nodes[index].left;
+        } else {
+            index = untouched++;
+        }
+        std::construct_at(&valueAt(index), std::move(value));
+        nodes[index] = Node{0, 0, 1};
+        ++count;
+        AVL_COUNT(++counters.allocations);
+        return index;
+    }
+
+    void release(const Index index) {
+        std::destroy_at(&valueAt(index));
+        nodes[index] = Node{freeList, 0, 0};
+        freeList = index;
+        --count;
+        AVL_COUNT(++counters.frees);
+    }
+
+    Index insert(const Index node, T& value, AVLInsertStatus& status) {
+        if (!node) {
+            if (count == Capacity) {
+                status = AVLInsertStatus::Full;
+                return 0;
+            }
+            status = AVLInsertStatus::Inserted;
+            return allocate(value);
+        }
+
+        if (value < valueAt(node)) {
+            AVL_COUNT(++counters.updateComparisons);
+            nodes[node].left = insert(nodes[node].left, value, status);
+        } else if (value > valueAt(node)) {
+            AVL_COUNT(counters.updateComparisons += 2);
+            nodes[node].right = insert(nodes[node].right, value, status);
+        } else {
+            AVL_COUNT(counters.updateComparisons += 2);
+            status = AVLInsertStatus::AlreadyPresent;
+            return node;
+        }
+
+        return status == AVLInsertStatus::Inserted ? balance(node) : node;
+    }
+
+    std::pair<Index, Index> detachMin(const Index node) {
+        if (!nodes[node].left) {
+            return {nodes[node].right, node};
+        }
+
+        auto [rest, min] = detachMin(nodes[node].left);
+        nodes[node].left = rest;
+        return {balance(node), min};
+    }
+
+    Index remove(const Index node, const T& value) {
+        if (!node) return 0;
+
+        if (value < valueAt(node)) {
+            AVL_COUNT(++counters.updateComparisons);
+            nodes[node].left = remove(nodes[node].left, value);
+        } else if (value > valueAt(node)) {
+            AVL_COUNT(counters.updateComparisons += 2);
+            nodes[node].right = remove(nodes[node].right, value);
+        } else {
+            AVL_COUNT(counters.updateComparisons += 2);
+            const Node removed = nodes[node];
+            release(node);
+            if (!removed.left) return removed.right;
+            if (!removed.right) return removed.left;
+
+            auto [rest, successor] = detachMin(removed.right);
+            nodes[successor].left = removed.left;
+            nodes[successor].right = rest;
+            return balance(successor);
+        }
+
+        return balance(node);
+    }
+
+    [[nodiscard]] Index search(const T& value) const {
+        Index node = root;
+        while (node) {
+            if (value < valueAt(node)) {
+                AVL_COUNT(++counters.searchComparisons);
+                node = nodes[node].left;
+            } else if (value > valueAt(node)) {
+                AVL_COUNT(counters.searchComparisons += 2);
+                node = nodes[node].right;
+            } else {
+                AVL_COUNT(counters.searchComparisons += 2);
+                break;
+            }
+        }
+        return node;
+    }
+
+    void inorderTraversal(const Index node, auto& visitor) const {
+        if (!node) return;
+
+        inorderTraversal(nodes[node].left, visitor);
+        visitor(valueAt(node));
+        inorderTraversal(nodes[node].right, visitor);
+    }
+
+    void rangeTraversal(const Index node, const T& low, const T& high, auto& visitor) const {
+        if (!node) return;
+
+        if (low < valueAt(node)) {
+            rangeTraversal(nodes[node].left, low, high, visitor);
+        }
+        if (!(valueAt(node) < low) && !(valueAt(node) > high)) {
+            visitor(valueAt(node));
+        }
+        if (high > valueAt(node)) {
+            rangeTraversal(nodes[node].right, low, high, visitor);
+        }
+    }
+
+    void destroyAll(const Index node) {
+        if (!node) return;
+
+        destroyAll(nodes[node].left);
+        destroyAll(nodes[node].right);
+        std::destroy_at(&valueAt(node));
+    }
+
+public:
+    StaticAVLTree() = default;
+
+    StaticAVLTree(const StaticAVLTree&) = delete;
+    StaticAVLTree& operator=(const StaticAVLTree&) = delete;
+
+    ~StaticAVLTree() {
+        if constexpr (!std::is_trivially_destructible_v<T>) destroyAll(root);
+    }
+
+    // Full only when value is not present and all Capacity nodes are in use; the tree is then
+    // unchanged.
+    AVLInsertStatus insert(T value) {
+        AVL_TRACE_SCOPE(Insert);
+        AVLInsertStatus status = AVLInsertStatus::AlreadyPresent;
+        root = insert(root, value, status);
+        AVL_COUNT(finishUpdate());
+        return status;
+    }
+
+    void remove(const T& value) {
+        AVL_TRACE_SCOPE(Remove);
+        root = remove(root, value);
+        AVL_COUNT(finishUpdate());
+    }
+
+    [[nodiscard]] static constexpr std::size_t capacity() { return Capacity; }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    [[nodiscard]] bool full() const { return count == Capacity; }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        AVL_TRACE_SCOPE(Search);
+        AVL_COUNT(++counters.searches);
+        return search(value) != 0;
+    }
+
+    [[nodiscard]] const T* find(const T& value) const {
+        AVL_TRACE_SCOPE(Search);
+        AVL_COUNT(++counters.searches);
+        const Index node = search(value);
+        return node ? &valueAt(node) : nullptr;
+    }
+
+    [[nodiscard]] const T* lower_bound(const T& value) const {
+        const T* candidate = nullptr;
+        for (Index node = root; node;) {
+            if (valueAt(node) < value) {
+                node = nodes[node].right;
+            } else {
+                candidate = &valueAt(node);
+                node = nodes[node].left;
+            }
+        }
+        return candidate;
+    }
+
+    [[nodiscard]] std::optional<T> get(const T& value) const {
+        const T* found = find(value);
+        return found ? std::optional<T>(*found) : std::nullopt;
+    }
+
+    [[nodiscard]] int height() const { return height(root); }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        inorderTraversal(root, visitor);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        rangeTraversal(root, low, high, visitor);
+    }
+
+    void print(std::ostream& os = std::cout) const {
+        os << "Tree structure (" << count << "/" << Capacity << " nodes):" << std::endl;
+
+        const auto indexOf = [this](const Node* node) { return static_cast<Index>(node - nodes.data()); };
+        const auto nodeOrNull = [this](const Index index) -> const Node* {
+            return index ? &nodes[index] : nullptr;
+        };
+
+        auto labelFn = [&](const Node* node) -> std::string {
+            if (!node) return "";
+            std::stringstream ss;
+            ss << valueAt(indexOf(node)) << "[" << balanceFactor(indexOf(node)) << "]";
+            return ss.str();
+        };
+
+        auto leftFn = [&](const Node* node) -> const Node* {
+            return node ? nodeOrNull(node->left) : nullptr;
+        };
+
+        auto rightFn = [&](const Node* node) -> const Node* {
+            return node ? nodeOrNull(node->right) : nullptr;
+        };
+
+        TreePrinter<T, Node> printer(labelFn, leftFn, rightFn, os);
+        printer.setSquareBranches(true);
+        printer.setHspace(3);
+        printer.printTree(nodeOrNull(root));
+
+        os << "\nInorder traversal: ";
+        inorder([&os](const T& value) { os << value << " "; });
+        os << std::endl;
+    }
+};
+
+#endif //STATICAVLTREE_H
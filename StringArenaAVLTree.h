@@ -0,0 +1,196 @@
+#ifndef STRINGARENAAVLTREE_H
+#define STRINGARENAAVLTREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "AVLTree.h"
+
+// Append-only storage for key bytes. Keys are packed back to back into 64 KiB chunks; keys
+// longer than half a chunk get a chunk of their own so they do not strand the rest of the
+// current one. Chunks never move, so views into them stay valid until the arena is destroyed.
+class StringArena {
+    static constexpr std::size_t chunkSize = 64 * 1024;
+
+    enum class LastAppend { InChunk, OpenedChunk, Large };
+
+    std::vector<std::unique_ptr<char[]>> chunks;
+    std::vector<std::unique_ptr<char[]>> largeChunks;
+    std::size_t chunkCapacity = 0;
+    std::size_t chunkUsed = 0;
+    // Fill of the chunk before the last one, restored when rolling back the append that opened it.
+    std::size_t previousCapacity = 0;
+    std::size_t previousUsed = 0;
+    std::size_t usedBytes = 0;
+    std::size_t reservedBytes = 0;
+    LastAppend last = LastAppend::InChunk;
+
+    void openChunk(const std::size_t capacity) {
+        previousCapacity = std::exchange(chunkCapacity, capacity);
+        previousUsed = std::exchange(chunkUsed, 0);
+        chunks.push_back(std::make_unique_for_overwrite<char[]>(capacity));
+        reservedBytes += capacity;
+    }
+
+public:
+    StringArena() = default;
+
+    // Sized for exactly this many bytes of small keys, as after a compaction.
+    explicit StringArena(const std::size_t expectedBytes) {
+        if (expectedBytes) openChunk(std::max(expectedBytes, chunkSize));
+    }
+
+    // Keys of this size go into a chunk of their own.
+    [[nodiscard]] static constexpr bool isLarge(const std::size_t size) { return size > chunkSize / 2; }
+
+    [[nodiscard]] std::string_view append(const std::string_view bytes) {
+        usedBytes += bytes.size();
+        if (isLarge(bytes.size())) {
+            largeChunks.push_back(std::make_unique_for_overwrite<char[]>(bytes.size()));
+            reservedBytes += bytes.size();
+            last = LastAppend::Large;
+            std::memcpy(largeChunks.back().get(), bytes.data(), bytes.size());
+            return {largeChunks.back().get(), bytes.size()};
+        }
+
+        last = LastAppend::InChunk;
+        if (chunks.empty() || bytes.size() > chunkCapacity - chunkUsed) {
+            openChunk(chunkSize);
+            last = LastAppend::OpenedChunk;
+        }
+        char* out = chunks.back().get() + chunkUsed;
+        if (!bytes.empty()) std::memcpy(out, bytes.data(), bytes.size());
+        chunkUsed += bytes.size();
+        return {out, bytes.size()};
+    }
+
+    // Takes back the most recent append of size bytes.
+    void rollback(const std::size_t size) {
+        usedBytes -= size;
+        switch (last) {
+            case LastAppend::Large:
+                reservedBytes -= size;
+                largeChunks.pop_back();
+                break;
+            case LastAppend::OpenedChunk:
+                reservedBytes -= chunkCapacity;
+                chunks.pop_back();
+                chunkCapacity = previousCapacity;
+                chunkUsed = previousUsed;
+                break;
+            case LastAppend::InChunk:
+                chunkUsed -= size;
+                break;
+        }
+        last = LastAppend::InChunk;
+    }
+
+    [[nodiscard]] std::size_t used() const { return usedBytes; }
+
+    [[nodiscard]] std::size_t reserved() const { return reservedBytes; }
+};
+
+// Ordered set of strings stored as AVLTree<std::string_view>, with the bytes of every key
+// copied into a tree-owned StringArena. An insert costs a node but no string allocation, and
+// key bytes end up densely packed. Since AVLKeyPrefix covers string_view, most comparisons still
+// stop at the prefix inside the node.
+//
+// The arena is append-only: removing a key leaves its bytes behind. compact() copies the live
+// keys into a fresh arena in order and rebuilds the tree from them in O(n); it invalidates all
+// pointers previously returned by find() and lower_bound().
+class StringArenaAVLTree {
+    AVLTree<std::string_view> tree;
+    StringArena arena;
+    std::size_t liveBytes = 0;
+    // Part of liveBytes that goes into shared chunks, which compact() sizes its arena for.
+    std::size_t liveSmallBytes = 0;
+
+    void countLive(const std::size_t size, const bool added) {
+        const std::size_t small = StringArena::isLarge(size) ? 0 : size;
+        if (added) {
+            liveBytes += size;
+            liveSmallBytes += small;
+        } else {
+            liveBytes -= size;
+            liveSmallBytes -= small;
+        }
+    }
+
+public:
+    StringArenaAVLTree() = default;
+
+    StringArenaAVLTree(const StringArenaAVLTree&) = delete;
+    StringArenaAVLTree& operator=(const StringArenaAVLTree&) = delete;
+
+    // Copies the key into the arena first, so only one descent is needed; if it turns out to be
+    // present already the copy is rolled back.
+    void insert(const std::string_view key) {
+        const std::size_t before = tree.size();
+        tree.insert(arena.append(key));
+        if (tree.size() == before) {
+            arena.rollback(key.size());
+        } else {
+            countLive(key.size(), true);
+        }
+    }
+
+    void remove(const std::string_view key) {
+        const std::size_t before = tree.size();
+        tree.remove(key);
+        if (tree.size() != before) countLive(key.size(), false);
+    }
+
+    void compact() {
+        std::vector<std::string_view> keys;
+        keys.reserve(tree.size());
+        StringArena packed(liveSmallBytes);
+        tree.inorder([&](const std::string_view key) { keys.push_back(packed.append(key)); });
+        tree = AVLTree<std::string_view>::fromSorted(std::move(keys));
+        arena = std::move(packed);
+    }
+
+    [[nodiscard]] std::size_t size() const { return tree.size(); }
+
+    [[nodiscard]] bool empty() const { return tree.empty(); }
+
+    [[nodiscard]] bool contains(const std::string_view key) const { return tree.contains(key); }
+
+    [[nodiscard]] const std::string_view* find(const std::string_view key) const { return tree.find(key); }
+
+    [[nodiscard]] const std::string_view* lower_bound(const std::string_view key) const {
+        return tree.lower_bound(key);
+    }
+
+    [[nodiscard]] std::optional<std::string_view> get(const std::string_view key) const { return tree.get(key); }
+
+    // Bytes of the keys currently in the tree.
+    [[nodiscard]] std::size_t keyBytes() const { return liveBytes; }
+
+    // Bytes left behind by removed keys, reclaimed by compact().
+    [[nodiscard]] std::size_t garbageBytes() const { return arena.used() - liveBytes; }
+
+    [[nodiscard]] std::size_t arenaBytes() const { return arena.reserved(); }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        tree.inorder(visitor);
+    }
+
+    template <typename Visitor>
+    void range(const std::string_view low, const std::string_view high, Visitor visitor) const {
+        tree.range(low, high, visitor);
+    }
+
+    void print(std::ostream& os = std::cout) const {
+        tree.print(os);
+    }
+};
+
+#endif //STRINGARENAAVLTREE_H
@@ -0,0 +1,191 @@
+#ifndef TREEPRINTER_H
+#define TREEPRINTER_H
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+
+template <typename T, typename NodeType>
+class TreePrinter {
+    struct TreeLine {
+        std::string line;
+        int leftOffset;
+        int rightOffset;
+
+        TreeLine(std::string l, const int left, const int right)
+            : line(std::move(l)), leftOffset(left), rightOffset(right) {}
+    };
+
+    std::function<std::string(const NodeType*)> getLabel;
+    std::function<const NodeType*(const NodeType*)> getLeft;
+    std::function<const NodeType*(const NodeType*)> getRight;
+
+    std::ostream& outStream;
+    bool squareBranches = false;
+    bool lrAgnostic = false;
+    int hspace = 2;
+
+    static std::string spaces(const int n) {
+        return std::string(std::max(0, n), ' ');
+    }
+
+    static int minLeftOffset(const std::vector<TreeLine>& treeLines) {
+        if (treeLines.empty()) return 0;
+        int minOffset = treeLines[0].leftOffset;
+        for (const auto& line : treeLines) {
+            minOffset = std::min(minOffset, line.leftOffset);
+        }
+        return minOffset;
+    }
+
+    static int maxRightOffset(const std::vector<TreeLine>& treeLines) {
+        if (treeLines.empty()) return 0;
+        int maxOffset = treeLines[0].rightOffset;
+        for (const auto& line : treeLines) {
+            maxOffset = std::max(maxOffset, line.rightOffset);
+        }
+        return maxOffset;
+    }
+
+    void printTreeLines(const std::vector<TreeLine>& treeLines) {
+        if (!treeLines.empty()) {
+            int minLeft = minLeftOffset(treeLines);
+            int maxRight = maxRightOffset(treeLines);
+            for (const auto& treeLine : treeLines) {
+                const int leftSpaces = -(minLeft - treeLine.leftOffset);
+                const int rightSpaces = maxRight - treeLine.rightOffset;
+                outStream << spaces(leftSpaces) << treeLine.line << spaces(rightSpaces) << std::endl;
+            }
+        }
+    }
+
+    std::vector<TreeLine> buildTreeLines(const NodeType* root) {
+        if (!root) return {};
+
+        std::string rootLabel = getLabel(root);
+        std::vector<TreeLine> leftTreeLines = buildTreeLines(getLeft(root));
+        std::vector<TreeLine> rightTreeLines = buildTreeLines(getRight(root));
+
+        int leftCount = leftTreeLines.size();
+        int rightCount = rightTreeLines.size();
+        int minCount = std::min(leftCount, rightCount);
+        int maxCount = std::max(leftCount, rightCount);
+
+        int maxRootSpacing = 0;
+        for (int i = 0; i < minCount; i++) {
+            int spacing = leftTreeLines[i].rightOffset - rightTreeLines[i].leftOffset;
+            maxRootSpacing = std::max(maxRootSpacing, spacing);
+        }
+
+        int rootSpacing = maxRootSpacing + hspace;
+        if (rootSpacing % 2 == 0) rootSpacing++;
+
+        std::vector<TreeLine> allTreeLines;
+
+        allTreeLines.push_back(TreeLine(rootLabel, -(rootLabel.length() - 1) / 2, rootLabel.length() / 2));
+
+        int leftTreeAdjust = 0;
+        int rightTreeAdjust = 0;
+
+        if (leftTreeLines.empty()) {
+            if (!rightTreeLines.empty()) {
+                if (squareBranches) {
+                    if (lrAgnostic) {
+                        allTreeLines.push_back(TreeLine("|", 0, 0));
+                    } else {
+                        allTreeLines.push_back(TreeLine("+--+", 0, 3));
+                        rightTreeAdjust = 3;
+                    }
+                } else {
+                    allTreeLines.push_back(TreeLine("\\", 1, 1));
+                    rightTreeAdjust = 2;
+                }
+            }
+        } else if (rightTreeLines.empty()) {
+            if (squareBranches) {
+                if (lrAgnostic) {
+                    allTreeLines.push_back(TreeLine("|", 0, 0));
+                } else {
+                    allTreeLines.push_back(TreeLine("+--+", -3, 0));
+                    leftTreeAdjust = -3;
+                }
+            } else {
+                allTreeLines.push_back(TreeLine("/", -1, -1));
+                leftTreeAdjust = -2;
+            }
+        } else {
+            if (squareBranches) {
+                int adjust = (rootSpacing / 2) + 1;
+                auto horizontal = std::string(rootSpacing / 2, '-');
+                std::string branch = "+" + horizontal + "+" + horizontal + "+";
+                allTreeLines.push_back(TreeLine(branch, -adjust, adjust));
+                rightTreeAdjust = adjust;
+                leftTreeAdjust = -adjust;
+            } else {
+                if (rootSpacing == 1) {
+                    allTreeLines.push_back(TreeLine("/ \\", -1, 1));
+                    rightTreeAdjust = 2;
+                    leftTreeAdjust = -2;
+                } else {
+                    for (int i = 1; i < rootSpacing; i += 2) {
+                        std::string branches = "/" + spaces(i) + "\\";
+                        allTreeLines.push_back(TreeLine(branches, -((i + 1) / 2), (i + 1) / 2));
+                    }
+                    rightTreeAdjust = (rootSpacing / 2) + 1;
+                    leftTreeAdjust = -((rootSpacing / 2) + 1);
+                }
+            }
+        }
+
+        for (int i = 0; i < maxCount; i++) {
+            if (i >= leftTreeLines.size()) {
+                TreeLine rightLine = rightTreeLines[i];
+                rightLine.leftOffset += rightTreeAdjust;
+                rightLine.rightOffset += rightTreeAdjust;
+                allTreeLines.push_back(rightLine);
+            } else if (i >= rightTreeLines.size()) {
+                TreeLine leftLine = leftTreeLines[i];
+                leftLine.leftOffset += leftTreeAdjust;
+                leftLine.rightOffset += leftTreeAdjust;
+                allTreeLines.push_back(leftLine);
+            } else {
+                const TreeLine& leftLine = leftTreeLines[i];
+                const TreeLine& rightLine = rightTreeLines[i];
+                int adjustedRootSpacing = (rootSpacing == 1 ? (squareBranches ? 1 : 3) : rootSpacing);
+                TreeLine combined(
+                    leftLine.line + spaces(adjustedRootSpacing - leftLine.rightOffset + rightLine.leftOffset) + rightLine.line,
+                    leftLine.leftOffset + leftTreeAdjust,
+                    rightLine.rightOffset + rightTreeAdjust
+                );
+                allTreeLines.push_back(combined);
+            }
+        }
+
+        return allTreeLines;
+    }
+
+public:
+    TreePrinter(
+        std::function<std::string(const NodeType*)> labelFn,
+        std::function<const NodeType*(const NodeType*)> leftFn,
+        std::function<const NodeType*(const NodeType*)> rightFn,
+        std::ostream& os = std::cout
+    ) : getLabel(std::move(labelFn)),
+        getLeft(std::move(leftFn)),
+        getRight(std::move(rightFn)),
+        outStream(os) {}
+
+    void setSquareBranches(const bool value) { squareBranches = value; }
+    void setLrAgnostic(const bool value) { lrAgnostic = value; }
+    void setHspace(const int value) { hspace = value; }
+
+    void printTree(const NodeType* root) {
+        std::vector<TreeLine> treeLines = buildTreeLines(root);
+        printTreeLines(treeLines);
+    }
+};
+
+#endif //TREEPRINTER_H
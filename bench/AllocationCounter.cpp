@@ -0,0 +1,103 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define ALLOCATION_COUNTING 1
+#endif
+
+namespace {
+    std::atomic<bool> counting{false};
+    std::atomic<std::int64_t> liveBytes{0};
+    std::atomic<std::int64_t> allocations{0};
+
+    void* allocate(const std::size_t size, const std::size_t alignment) {
+        void* p = alignment > alignof(std::max_align_t)
+                      ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                      : std::malloc(size ? size : 1);
+        if (!p) throw std::bad_alloc();
+#ifdef ALLOCATION_COUNTING
+        if (counting.load(std::memory_order_relaxed)) {
+            liveBytes.fetch_add(static_cast<std::int64_t>(malloc_usable_size(p)), std::memory_order_relaxed);
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+#endif
+        return p;
+    }
+
+    void deallocate(void* p) noexcept {
+        if (!p) return;
+#ifdef ALLOCATION_COUNTING
+        if (counting.load(std::memory_order_relaxed)) {
+            liveBytes.fetch_sub(static_cast<std::int64_t>(malloc_usable_size(p)), std::memory_order_relaxed);
+            allocations.fetch_sub(1, std::memory_order_relaxed);
+        }
+#endif
+        std::free(p);
+    }
+}
+
+bool allocationCountingSupported() {
+#ifdef ALLOCATION_COUNTING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void enableAllocationCounting() {
+    counting.store(true, std::memory_order_relaxed);
+}
+
+AllocationSnapshot allocationSnapshot() {
+    return {liveBytes.load(std::memory_order_relaxed), allocations.load(std::memory_order_relaxed)};
+}
+
+void trimHeap() {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+std::size_t residentBytes() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            return std::stoull(line.substr(6)) * 1024;
+        }
+    }
+    return 0;
+}
+
+void* operator new(const std::size_t size) { return allocate(size, 0); }
+void* operator new[](const std::size_t size) { return allocate(size, 0); }
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](const std::size_t size, const std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size, 0); } catch (...) { return nullptr; }
+}
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size, 0); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { deallocate(p); }
+void operator delete[](void* p) noexcept { deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { deallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { deallocate(p); }
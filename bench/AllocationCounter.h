@@ -0,0 +1,29 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// AllocationCounter.cpp replaces the global operator new and delete of the benchmark binary.
+// Counting stays off until enableAllocationCounting() is called, so the throughput modes do
+// not pay for it. Bytes are the allocator's usable size, which includes size-class rounding
+// but not the chunk header.
+
+struct AllocationSnapshot {
+    std::int64_t liveBytes = 0;
+    std::int64_t allocations = 0;
+};
+
+[[nodiscard]] bool allocationCountingSupported();
+
+void enableAllocationCounting();
+
+[[nodiscard]] AllocationSnapshot allocationSnapshot();
+
+// Returns freed heap pages to the kernel so the next resident-size reading starts low.
+void trimHeap();
+
+// VmRSS from /proc/self/status, 0 where that file does not exist.
+[[nodiscard]] std::size_t residentBytes();
+
+#endif //ALLOCATIONCOUNTER_H
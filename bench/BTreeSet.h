@@ -0,0 +1,234 @@
+#ifndef BTREESET_H
+#define BTREESET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+template <typename T, std::size_t MinDegree = 32>
+class BTreeSet {
+    static_assert(MinDegree >= 2, "a B-tree needs a minimum degree of at least 2");
+
+    struct Node {
+        std::vector<T> keys;
+        std::vector<std::unique_ptr<Node>> children;
+
+        [[nodiscard]] bool leaf() const { return children.empty(); }
+    };
+
+    static constexpr std::size_t maxKeys = 2 * MinDegree - 1;
+
+    std::unique_ptr<Node> root;
+    std::size_t count = 0;
+
+    [[nodiscard]] static std::size_t lowerIndex(const Node* node, const T& value) {
+        return std::lower_bound(node->keys.begin(), node->keys.end(), value) - node->keys.begin();
+    }
+
+    static void splitChild(Node* parent, const std::size_t i) {
+        Node* child = parent->children[i].get();
+        auto sibling = std::make_unique<Node>();
+
+        sibling->keys.assign(std::make_move_iterator(child->keys.begin() + MinDegree),
+                             std::make_move_iterator(child->keys.end()));
+        T median = std::move(child->keys[MinDegree - 1]);
+        child->keys.resize(MinDegree - 1);
+
+        if (!child->leaf()) {
+            sibling->children.assign(std::make_move_iterator(child->children.begin() + MinDegree),
+                                     std::make_move_iterator(child->children.end()));
+            child->children.resize(MinDegree);
+        }
+
+        parent->keys.insert(parent->keys.begin() + i, std::move(median));
+        parent->children.insert(parent->children.begin() + i + 1, std::move(sibling));
+    }
+
+    static bool insertNonFull(Node* node, const T& value) {
+        while (true) {
+            std::size_t i = lowerIndex(node, value);
+            if (i < node->keys.size() && node->keys[i] == value) return false;
+
+            if (node->leaf()) {
+                node->keys.insert(node->keys.begin() + i, value);
+                return true;
+            }
+
+            if (node->children[i]->keys.size() == maxKeys) {
+                splitChild(node, i);
+                if (node->keys[i] == value) return false;
+                if (node->keys[i] < value) ++i;
+            }
+            node = node->children[i].get();
+        }
+    }
+
+    static void mergeChildren(Node* node, const std::size_t i) {
+        Node* left = node->children[i].get();
+        std::unique_ptr<Node> right = std::move(node->children[i + 1]);
+
+        left->keys.push_back(std::move(node->keys[i]));
+        left->keys.insert(left->keys.end(), std::make_move_iterator(right->keys.begin()),
+                          std::make_move_iterator(right->keys.end()));
+        left->children.insert(left->children.end(), std::make_move_iterator(right->children.begin()),
+                              std::make_move_iterator(right->children.end()));
+
+        node->keys.erase(node->keys.begin() + i);
+        node->children.erase(node->children.begin() + i + 1);
+    }
+
+    static void borrowFromLeft(Node* node, const std::size_t i) {
+        Node* child = node->children[i].get();
+        Node* sibling = node->children[i - 1].get();
+
+        child->keys.insert(child->keys.begin(), std::move(node->keys[i - 1]));
+        node->keys[i - 1] = std::move(sibling->keys.back());
+        sibling->keys.pop_back();
+
+        if (!sibling->leaf()) {
+            child->children.insert(child->children.begin(), std::move(sibling->children.back()));
+            sibling->children.pop_back();
+        }
+    }
+
+    static void borrowFromRight(Node* node, const std::size_t i) {
+        Node* child = node->children[i].get();
+        Node* sibling = node->children[i + 1].get();
+
+        child->keys.push_back(std::move(node->keys[i]));
+        node->keys[i] = std::move(sibling->keys.front());
+        sibling->keys.erase(sibling->keys.begin());
+
+        if (!sibling->leaf()) {
+            child->children.push_back(std::move(sibling->children.front()));
+            sibling->children.erase(sibling->children.begin());
+        }
+    }
+
+    // Makes sure children[i] holds at least MinDegree keys before descending into it and
+    // returns the index of the child that now covers the same key range.
+    static std::size_t fillChild(Node* node, std::size_t i) {
+        if (node->children[i]->keys.size() >= MinDegree) return i;
+
+        if (i > 0 && node->children[i - 1]->keys.size() >= MinDegree) {
+            borrowFromLeft(node, i);
+        } else if (i + 1 < node->children.size() && node->children[i + 1]->keys.size() >= MinDegree) {
+            borrowFromRight(node, i);
+        } else if (i + 1 < node->children.size()) {
+            mergeChildren(node, i);
+        } else {
+            mergeChildren(node, i - 1);
+            --i;
+        }
+        return i;
+    }
+
+    static bool erase(Node* node, T target) {
+        while (true) {
+            std::size_t i = lowerIndex(node, target);
+            const bool found = i < node->keys.size() && node->keys[i] == target;
+
+            if (node->leaf()) {
+                if (!found) return false;
+                node->keys.erase(node->keys.begin() + i);
+                return true;
+            }
+
+            if (found) {
+                Node* left = node->children[i].get();
+                Node* right = node->children[i + 1].get();
+
+                if (left->keys.size() >= MinDegree) {
+                    const Node* pred = left;
+                    while (!pred->leaf()) pred = pred->children.back().get();
+                    node->keys[i] = pred->keys.back();
+                    target = node->keys[i];
+                    node = left;
+                } else if (right->keys.size() >= MinDegree) {
+                    const Node* succ = right;
+                    while (!succ->leaf()) succ = succ->children.front().get();
+                    node->keys[i] = succ->keys.front();
+                    target = node->keys[i];
+                    node = right;
+                } else {
+                    mergeChildren(node, i);
+                    node = left;
+                }
+                continue;
+            }
+
+            i = fillChild(node, i);
+            node = node->children[i].get();
+        }
+    }
+
+    static void rangeVisit(const Node* node, const T& low, const T& high, auto& visitor) {
+        std::size_t i = lowerIndex(node, low);
+        for (; i < node->keys.size(); ++i) {
+            if (!node->leaf()) rangeVisit(node->children[i].get(), low, high, visitor);
+            if (node->keys[i] > high) return;
+            visitor(node->keys[i]);
+        }
+        if (!node->leaf()) rangeVisit(node->children[i].get(), low, high, visitor);
+    }
+
+    static void inorderVisit(const Node* node, auto& visitor) {
+        for (std::size_t i = 0; i < node->keys.size(); ++i) {
+            if (!node->leaf()) inorderVisit(node->children[i].get(), visitor);
+            visitor(node->keys[i]);
+        }
+        if (!node->leaf()) inorderVisit(node->children.back().get(), visitor);
+    }
+
+public:
+    BTreeSet() : root(std::make_unique<Node>()) {}
+
+    bool insert(const T& value) {
+        if (root->keys.size() == maxKeys) {
+            auto newRoot = std::make_unique<Node>();
+            newRoot->children.push_back(std::move(root));
+            root = std::move(newRoot);
+            splitChild(root.get(), 0);
+        }
+
+        if (!insertNonFull(root.get(), value)) return false;
+        ++count;
+        return true;
+    }
+
+    bool erase(const T& value) {
+        const bool erased = erase(root.get(), value);
+        if (root->keys.empty() && !root->leaf()) {
+            root = std::move(root->children.front());
+        }
+        if (erased) --count;
+        return erased;
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        const Node* node = root.get();
+        while (node) {
+            const std::size_t i = lowerIndex(node, value);
+            if (i < node->keys.size() && node->keys[i] == value) return true;
+            node = node->leaf() ? nullptr : node->children[i].get();
+        }
+        return false;
+    }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        rangeVisit(root.get(), low, high, visitor);
+    }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        inorderVisit(root.get(), visitor);
+    }
+};
+
+#endif //BTREESET_H
@@ -0,0 +1,270 @@
+#ifndef BACKENDS_H
+#define BACKENDS_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<flat_set>)
+#include <flat_set>
+#endif
+
+#include "AVLTree.h"
+#include "AdaptiveRadixTree.h"
+#include "BTreeSet.h"
+#include "BucketedAVLTree.h"
+#include "CachedAVLTree.h"
+#include "FilteredAVLTree.h"
+#include "IndexedAVLTree.h"
+#include "SmallAVLTree.h"
+#include "StaticAVLTree.h"
+#include "StringArenaAVLTree.h"
+
+// Every backend exposes the same small ordered-set surface so the harness can drive them
+// through one template: insert, remove, contains, range (inclusive) and inorder.
+// maxSize caps containers whose inserts are linear, otherwise the large sizes never finish.
+
+// String literal usable as a template argument, for backend names.
+template <std::size_t N>
+struct fixed_string {
+    char chars[N]{};
+
+    constexpr fixed_string(const char (&text)[N]) { std::copy_n(text, N, chars); }
+
+    constexpr operator std::string_view() const { return {chars, N - 1}; }
+};
+
+// Backend for the trees of this repository, which all share the set surface above. Trees too
+// large for the stack (StaticAVLTree's fixed node array) sit on the heap; their operations
+// still never allocate.
+template <typename Tree, fixed_string Name, std::size_t MaxSize = std::numeric_limits<std::size_t>::max()>
+struct TreeBackend {
+    static constexpr std::string_view name = Name;
+    static constexpr std::size_t maxSize = MaxSize;
+    static constexpr bool onHeap = sizeof(Tree) > std::size_t{1} << 16;
+
+    std::conditional_t<onHeap, std::unique_ptr<Tree>, Tree> tree = make();
+
+    template <typename Key>
+    void insert(const Key& value) { get().insert(value); }
+
+    template <typename Key>
+    void remove(const Key& value) { get().remove(value); }
+
+    template <typename Key>
+    [[nodiscard]] bool contains(const Key& value) const { return get().contains(value); }
+
+    template <typename Key, typename Visitor>
+    void range(const Key& low, const Key& high, Visitor visitor) const { get().range(low, high, visitor); }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const { get().inorder(visitor); }
+
+private:
+    [[nodiscard]] static auto make() {
+        if constexpr (onHeap) return std::make_unique<Tree>();
+        else return Tree{};
+    }
+
+    [[nodiscard]] Tree& get() {
+        if constexpr (onHeap) return *tree;
+        else return tree;
+    }
+
+    [[nodiscard]] const Tree& get() const {
+        if constexpr (onHeap) return *tree;
+        else return tree;
+    }
+};
+
+template <typename T>
+using AVLBackend = TreeBackend<AVLTree<T>, "AVLTree">;
+
+template <typename T>
+using FilteredAVLBackend = TreeBackend<FilteredAVLTree<T>, "AVLTree+bloom">;
+
+template <typename T>
+using CachedAVLBackend = TreeBackend<CachedAVLTree<T>, "AVLTree+cache">;
+
+template <typename T>
+using IndexedAVLBackend = TreeBackend<IndexedAVLTree<T>, "AVLTree+index">;
+
+template <typename T>
+using SmallAVLBackend = TreeBackend<SmallAVLTree<T>, "SmallAVLTree">;
+
+template <typename T>
+using StaticAVLBackend = TreeBackend<StaticAVLTree<T, std::size_t{1} << 20>, "StaticAVLTree", std::size_t{1} << 20>;
+
+// String keys only: visitors see std::string_view instead of const std::string&.
+using StringArenaAVLBackend = TreeBackend<StringArenaAVLTree, "AVLTree+arena">;
+
+template <typename T>
+using ARTBackend = TreeBackend<AdaptiveRadixTree<T>, "AdaptiveRadixTree">;
+
+template <typename T>
+using BucketedAVLBackend = TreeBackend<BucketedAVLTree<T>, "BucketedAVLTree">;
+
+template <typename T>
+struct StdSetBackend {
+    static constexpr std::string_view name = "std::set";
+    static constexpr std::size_t maxSize = std::numeric_limits<std::size_t>::max();
+
+    std::set<T> set;
+
+    void insert(const T& value) { set.insert(value); }
+    void remove(const T& value) { set.erase(value); }
+    [[nodiscard]] bool contains(const T& value) const { return set.contains(value); }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        for (auto it = set.lower_bound(low); it != set.end() && !(*it > high); ++it) {
+            visitor(*it);
+        }
+    }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        for (const T& value : set) visitor(value);
+    }
+};
+
+template <typename T>
+struct SortedVectorBackend {
+    static constexpr std::string_view name = "sorted std::vector";
+    static constexpr std::size_t maxSize = 100'000;
+
+    std::vector<T> values;
+
+    void insert(const T& value) {
+        const auto it = std::lower_bound(values.begin(), values.end(), value);
+        if (it == values.end() || !(*it == value)) values.insert(it, value);
+    }
+
+    void remove(const T& value) {
+        const auto it = std::lower_bound(values.begin(), values.end(), value);
+        if (it != values.end() && *it == value) values.erase(it);
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        return std::binary_search(values.begin(), values.end(), value);
+    }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        for (auto it = std::lower_bound(values.begin(), values.end(), low);
+             it != values.end() && !(*it > high); ++it) {
+            visitor(*it);
+        }
+    }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        for (const T& value : values) visitor(value);
+    }
+};
+
+#if defined(__cpp_lib_flat_set)
+template <typename T>
+struct FlatSetBackend {
+    static constexpr std::string_view name = "std::flat_set";
+    static constexpr std::size_t maxSize = 100'000;
+
+    std::flat_set<T> set;
+
+    void insert(const T& value) { set.insert(value); }
+    void remove(const T& value) { set.erase(value); }
+    [[nodiscard]] bool contains(const T& value) const { return set.contains(value); }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const {
+        for (auto it = set.lower_bound(low); it != set.end() && !(*it > high); ++it) {
+            visitor(*it);
+        }
+    }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const {
+        for (const T& value : set) visitor(value);
+    }
+};
+#endif
+
+template <typename T>
+struct BTreeBackend {
+    static constexpr std::string_view name = "BTreeSet";
+    static constexpr std::size_t maxSize = std::numeric_limits<std::size_t>::max();
+
+    BTreeSet<T> tree;
+
+    void insert(const T& value) { tree.insert(value); }
+    void remove(const T& value) { tree.erase(value); }
+    [[nodiscard]] bool contains(const T& value) const { return tree.contains(value); }
+
+    template <typename Visitor>
+    void range(const T& low, const T& high, Visitor visitor) const { tree.range(low, high, visitor); }
+
+    template <typename Visitor>
+    void inorder(Visitor visitor) const { tree.inorder(visitor); }
+};
+
+// The one list of benchmarked backends, in report order: calls
+// fn.template operator()<Backend>(key) for every backend usable with key type T, where key is
+// the name --backends selects it by.
+template <typename T, typename Fn>
+void forEachRegisteredBackend(Fn&& fn) {
+    fn.template operator()<AVLBackend<T>>("avl");
+    fn.template operator()<FilteredAVLBackend<T>>("bloom");
+    fn.template operator()<CachedAVLBackend<T>>("cache");
+    fn.template operator()<IndexedAVLBackend<T>>("index");
+    fn.template operator()<SmallAVLBackend<T>>("small");
+    fn.template operator()<StaticAVLBackend<T>>("static");
+    if constexpr (std::same_as<T, std::string>) fn.template operator()<StringArenaAVLBackend>("arena");
+    fn.template operator()<ARTBackend<T>>("art");
+    fn.template operator()<BucketedAVLBackend<T>>("bucket");
+    fn.template operator()<StdSetBackend<T>>("set");
+    fn.template operator()<SortedVectorBackend<T>>("vector");
+#if defined(__cpp_lib_flat_set)
+    fn.template operator()<FlatSetBackend<T>>("flatset");
+#endif
+    fn.template operator()<BTreeBackend<T>>("btree");
+}
+
+// Keys of every registered backend; string keys have them all.
+[[nodiscard]] inline std::vector<std::string> backendKeys() {
+    std::vector<std::string> keys;
+    forEachRegisteredBackend<std::string>([&]<typename>(const std::string_view key) { keys.emplace_back(key); });
+    return keys;
+}
+
+// Command line helpers shared by the benchmark and replay tools.
+[[nodiscard]] inline std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::size_t begin = 0;
+    while (begin <= list.size()) {
+        const std::size_t end = std::min(list.find(',', begin), list.size());
+        if (end > begin) items.push_back(list.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return items;
+}
+
+// Sizes accept scientific notation, so "--max-size 1e8" works.
+[[nodiscard]] inline std::size_t parseCount(const std::string& text) {
+    return static_cast<std::size_t>(std::stod(text));
+}
+
+// backendKeys() as a comma separated list, for --help.
+[[nodiscard]] inline std::string backendKeyList() {
+    std::string list;
+    for (const std::string& key : backendKeys()) list += (list.empty() ? "" : ",") + key;
+    return list;
+}
+
+#endif //BACKENDS_H
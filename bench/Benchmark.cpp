@@ -0,0 +1,488 @@
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "Backends.h"
+#include "ConcurrentBackends.h"
+#include "Harness.h"
+#include "Keys.h"
+#include "PerfCounters.h"
+#include "Scalability.h"
+#include "Workload.h"
+
+struct Options {
+    std::size_t minSize = 1'000;
+    std::size_t maxSize = 1'000'000;
+    std::size_t batch = 64;
+    std::size_t queries = 1'000'000;
+    std::size_t rangeWidth = 100;
+    std::uint64_t seed = 42;
+    Reporter::Format format = Reporter::Format::Csv;
+    bool perf = false;
+    bool memory = false;
+    std::vector<std::string> backends = backendKeys();
+    std::vector<std::string> keyTypes{"int", "string"};
+    // A non-empty workload replaces the per-operation microbenchmarks with one mixed stream.
+    std::string workload;
+    std::size_t workloadOps = 1'000'000;
+    WorkloadConfig workloadConfig;
+    // Non-zero runs the multithreaded scalability scenario with 1..threads threads.
+    std::size_t threads = 0;
+    unsigned readPercent = 90;
+    std::vector<std::string> concurrent{"mutex", "rwlock", "sharded", "snapshot"};
+    std::string tracePath;
+};
+
+// Present keys are built from even ordinals and misses from odd ones, so half of the lookups
+// hit and half walk down to an empty child.
+template <typename T>
+struct KeySet {
+    std::vector<T> insertOrder;
+    std::vector<T> removeOrder;
+    std::vector<T> lookups;
+    std::vector<std::pair<T, T>> ranges;
+
+    KeySet(const std::size_t n, const Options& options) {
+        std::mt19937_64 rng(options.seed ^ n);
+
+        insertOrder.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            insertOrder.push_back(makeKey<T>(2 * i));
+        }
+        std::shuffle(insertOrder.begin(), insertOrder.end(), rng);
+
+        removeOrder = insertOrder;
+        std::shuffle(removeOrder.begin(), removeOrder.end(), rng);
+
+        std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+        const std::size_t lookupCount = std::min(options.queries, 2 * n);
+        lookups.reserve(lookupCount);
+        for (std::size_t i = 0; i < lookupCount; ++i) {
+            lookups.push_back(i % 2 == 0 ? insertOrder[pick(rng)] : makeKey<T>(2 * pick(rng) + 1));
+        }
+
+        std::vector<T> sorted = insertOrder;
+        std::sort(sorted.begin(), sorted.end());
+        const std::size_t width = std::min(options.rangeWidth, n);
+        const std::size_t rangeCount = std::max<std::size_t>(1, std::min(n, options.queries / std::max<std::size_t>(width, 1)));
+        std::uniform_int_distribution<std::size_t> start(0, n - width);
+        ranges.reserve(rangeCount);
+        for (std::size_t i = 0; i < rangeCount; ++i) {
+            const std::size_t first = start(rng);
+            ranges.emplace_back(sorted[first], sorted[first + width - 1]);
+        }
+    }
+};
+
+// Counter totals are divided by the operations of the region, so they read as events per op.
+void attachCounters(Result& result, const PerfCounters::Sample& sample) {
+    const auto ops = static_cast<double>(std::max<std::size_t>(1, result.measurement.ops));
+    for (int i = 0; i < PerfCounters::EventCount; ++i) {
+        result.extra.emplace_back(std::string(PerfCounters::names[i]),
+                                  sample[i] ? std::optional(*sample[i] / ops) : std::nullopt);
+    }
+}
+
+// measure() region reading the counters over exactly the timed loop.
+struct PerfRegion {
+    PerfCounters* perf;
+    PerfCounters::Sample sample{};
+
+    void start() {
+        if (perf) perf->start();
+    }
+
+    void stop() {
+        if (perf) sample = perf->stop();
+    }
+};
+
+[[nodiscard]] Measurement scaled(Measurement m, const double divisor) {
+    m.nsPerOp /= divisor;
+    m.p50 /= divisor;
+    m.p90 /= divisor;
+    m.p99 /= divisor;
+    m.p999 /= divisor;
+    m.max /= divisor;
+    return m;
+}
+
+template <typename Backend, typename T>
+void runBackend(const KeySet<T>& keys, const std::string& keyType, const Options& options, Reporter& reporter,
+                PerfCounters* perf) {
+    const std::size_t n = keys.insertOrder.size();
+    if (n > Backend::maxSize) {
+        std::cerr << "skipping " << Backend::name << " at size " << n << " (limit " << Backend::maxSize << ")" << std::endl;
+        return;
+    }
+
+    Backend backend;
+
+    PerfRegion region{perf};
+
+    auto report = [&](const std::string& operation, const Measurement& m) {
+        Result result{std::string(Backend::name), keyType, operation, n, m};
+        if (perf) attachCounters(result, region.sample);
+        reporter.add(result);
+        if constexpr (requires { backend.tree.operationCounters(); }) {
+            if (backend.tree.countersEnabled) {
+                std::cerr << Backend::name << ',' << keyType << ',' << operation << ',' << n << ": "
+                          << backend.tree.operationCounters() << std::endl;
+                backend.tree.resetCounters();
+            }
+        }
+    };
+
+    report("insert", measure(n, options.batch, [&](const std::size_t i) {
+        backend.insert(keys.insertOrder[i]);
+    }, region));
+
+    std::size_t hits = 0;
+    report("contains", measure(keys.lookups.size(), options.batch, [&](const std::size_t i) {
+        hits += backend.contains(keys.lookups[i]);
+    }, region));
+    doNotOptimize(hits);
+
+    std::size_t visited = 0;
+    auto visit = [&visited](const auto& value) {
+        doNotOptimize(value);
+        ++visited;
+    };
+
+    report("range", measure(keys.ranges.size(), std::max<std::size_t>(1, options.batch / 8), [&](const std::size_t i) {
+        backend.range(keys.ranges[i].first, keys.ranges[i].second, visit);
+    }, region));
+    doNotOptimize(visited);
+
+    const std::size_t passes = std::clamp<std::size_t>(options.queries / n, 1, 20);
+    Measurement iteration = measure(passes, 1, [&](std::size_t) {
+        backend.inorder(visit);
+    }, region);
+    doNotOptimize(visited);
+    iteration = scaled(iteration, static_cast<double>(n));
+    iteration.ops = passes * n;
+    report("iterate", iteration);
+
+    if constexpr (std::copy_constructible<Backend>) {
+        Measurement copying = measure(passes, 1, [&](std::size_t) {
+            const Backend copy(backend);
+            doNotOptimize(copy);
+        }, region);
+        copying = scaled(copying, static_cast<double>(n));
+        copying.ops = passes * n;
+        report("copy", copying);
+    }
+
+    report("remove", measure(n, options.batch, [&](const std::size_t i) {
+        backend.remove(keys.removeOrder[i]);
+    }, region));
+}
+
+template <typename Backend, typename T>
+void runWorkload(const std::vector<T>& preload, const std::vector<TypedOperation<T>>& ops, const std::string& keyType,
+                 const Options& options, Reporter& reporter, PerfCounters* perf) {
+    if (preload.size() > Backend::maxSize) {
+        std::cerr << "skipping " << Backend::name << " with preload " << preload.size() << " (limit "
+                  << Backend::maxSize << ")" << std::endl;
+        return;
+    }
+
+    Backend backend;
+    for (const T& key : preload) {
+        backend.insert(key);
+    }
+
+    std::size_t sink = 0;
+    PerfRegion region{perf};
+    const Measurement m = measure(ops.size(), options.batch, [&](const std::size_t i) {
+        apply(backend, ops[i], sink);
+    }, region);
+    doNotOptimize(sink);
+
+    Result result{std::string(Backend::name), keyType, "workload:" + options.workload, preload.size(), m};
+    if (perf) attachCounters(result, region.sample);
+    reporter.add(result);
+}
+
+// Heap bytes are what the container holds after n inserts, including the copies of string
+// keys, counted by the replaced operator new. The resident-size delta also sees allocator
+// slack and page granularity, so it is noisy below roughly 1e5 elements.
+template <typename Backend, typename T>
+void runMemory(const KeySet<T>& keys, const std::string& keyType, const Options& options, Reporter& reporter) {
+    const std::size_t n = keys.insertOrder.size();
+    if (n > Backend::maxSize) {
+        std::cerr << "skipping " << Backend::name << " at size " << n << " (limit " << Backend::maxSize << ")" << std::endl;
+        return;
+    }
+
+    trimHeap();
+    const AllocationSnapshot before = allocationSnapshot();
+    const std::size_t rssBefore = residentBytes();
+
+    Backend backend;
+    const Measurement m = measure(n, options.batch, [&](const std::size_t i) {
+        backend.insert(keys.insertOrder[i]);
+    });
+
+    const AllocationSnapshot after = allocationSnapshot();
+    const std::size_t rssAfter = residentBytes();
+    const auto perElement = [n](const double value) { return std::optional(value / static_cast<double>(n)); };
+
+    Result result{std::string(Backend::name), keyType, "memory", n, m};
+    result.extra = {
+        {"heap_bytes_per_element", perElement(static_cast<double>(after.liveBytes - before.liveBytes))},
+        {"allocations_per_element", perElement(static_cast<double>(after.allocations - before.allocations))},
+        {"rss_bytes_per_element", perElement(rssAfter > rssBefore ? static_cast<double>(rssAfter - rssBefore) : 0.0)},
+    };
+    reporter.add(result);
+}
+
+// Calls fn.template operator()<Backend>() for every backend selected on the command line.
+template <typename T, typename Fn>
+void forEachBackend(const Options& options, Fn&& fn) {
+    auto selected = [&options](const std::string_view name) {
+        return std::find(options.backends.begin(), options.backends.end(), name) != options.backends.end();
+    };
+
+    forEachRegisteredBackend<T>([&]<typename Backend>(const std::string_view key) {
+        if (selected(key)) fn.template operator()<Backend>();
+    });
+}
+
+template <typename T>
+void runWorkloadKeyType(const std::string& keyType, const Options& options, Reporter& reporter, PerfCounters* perf) {
+    WorkloadGenerator generator(options.workloadConfig);
+    std::vector<T> preload;
+    for (const std::uint64_t key : generator.preload()) {
+        preload.push_back(makeKey<T>(key));
+    }
+    const std::vector<TypedOperation<T>> ops = materialize<T>(generator.generate(options.workloadOps));
+
+    forEachBackend<T>(options, [&]<typename Backend>() {
+        runWorkload<Backend>(preload, ops, keyType, options, reporter, perf);
+    });
+}
+
+// Publishing a snapshot copies the whole tree, so the snapshot variant batches its writes;
+// with one copy per write a single run over the default key space would take hours.
+constexpr std::size_t snapshotPublishEvery = 1024;
+
+template <typename T>
+void runScalabilityKeyType(const std::string& keyType, const Options& options, Reporter& reporter) {
+    ScalabilityConfig config;
+    config.maxThreads = options.threads;
+    config.opsPerThread = options.workloadOps;
+    config.keySpace = options.workloadConfig.keySpace;
+    config.readPercent = options.readPercent;
+    config.seed = options.seed;
+
+    auto selected = [&options](const std::string_view name) {
+        return std::find(options.concurrent.begin(), options.concurrent.end(), name) != options.concurrent.end();
+    };
+
+    for (const std::size_t threads : threadCounts(config.maxThreads)) {
+        if (selected("mutex")) reporter.add(runScalability<MutexAVLTree<T>, T>(threads, config, keyType));
+        if (selected("rwlock")) reporter.add(runScalability<SharedMutexAVLTree<T>, T>(threads, config, keyType));
+        if (selected("sharded")) reporter.add(runScalability<ShardedAVLTree<T>, T>(threads, config, keyType));
+        if (selected("snapshot")) {
+            reporter.add(runScalability<SnapshotAVLTree<T, snapshotPublishEvery>, T>(threads, config, keyType));
+        }
+    }
+}
+
+template <typename T>
+void runKeyType(const std::string& keyType, const Options& options, Reporter& reporter, PerfCounters* perf) {
+    for (std::size_t n = options.minSize; n <= options.maxSize; n *= 10) {
+        const KeySet<T> keys(n, options);
+
+        forEachBackend<T>(options, [&]<typename Backend>() {
+            if (options.memory) runMemory<Backend>(keys, keyType, options, reporter);
+            else runBackend<Backend>(keys, keyType, options, reporter, perf);
+        });
+    }
+}
+
+void printUsage(std::ostream& os) {
+    os << "Usage: AuD_Praktikum_1_benchmark [options]\n"
+          "  --min-size N       smallest tree size (default 1e3)\n"
+          "  --max-size N       largest tree size, grows by 10x (default 1e6, up to 1e8)\n"
+          "  --backends LIST    comma separated: " << backendKeyList() << "\n"
+          "  --keys LIST        comma separated: int,string\n"
+          "  --queries N        lookups per size, also bounds range scans and iteration passes\n"
+          "  --range-width N    elements per range scan (default 100)\n"
+          "  --batch N          operations per timing sample (default 64)\n"
+          "  --seed N           seed for key order and lookups (default 42)\n"
+          "  --format csv|json  output format (default csv)\n"
+          "  --perf             add hardware counters per operation (Linux perf_event_open)\n"
+          "  --trace FILE       write AVLTree events as Chrome trace JSON (needs AVL_TREE_TRACING)\n"
+          "  --memory           report heap, allocation and RSS bytes per element after inserting\n"
+          "\n"
+          "Mixed workload mode:\n"
+          "  --workload NAME    uniform, zipf, sequential or window\n"
+          "  --ops N            operations in the measured stream (default 1e6)\n"
+          "  --key-space N      distinct keys for uniform and zipf (default 1e6)\n"
+          "  --preload N        keys inserted before timing starts (default 1e5)\n"
+          "  --zipf-skew X      zipf exponent (default 0.99)\n"
+          "  --window N         live keys in the sliding window (default 1e5)\n"
+          "  --mix I,R,L,S      insert/remove/lookup/range weights (default 10,10,75,5)\n"
+          "\n"
+          "Multithreaded scalability mode:\n"
+          "  --threads N        run 1, 2, 4, ... up to N threads, 0 means all hardware threads\n"
+          "  --read-percent P   share of lookups, the rest splits into inserts and removes (default 90)\n"
+          "  --concurrent LIST  comma separated: mutex,rwlock,sharded,snapshot\n"
+          "  --ops and --key-space set the operations per thread and the key space\n";
+}
+
+Options parseOptions(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+        if (const auto eq = arg.find('='); eq != std::string::npos) {
+            value = arg.substr(eq + 1);
+            arg.resize(eq);
+        } else if (arg != "--help" && arg != "--perf" && arg != "--memory") {
+            if (i + 1 >= argc) throw std::invalid_argument("missing value for " + arg);
+            value = argv[++i];
+        }
+
+        if (arg == "--help") {
+            printUsage(std::cout);
+            std::exit(0);
+        } else if (arg == "--perf") {
+            options.perf = true;
+        } else if (arg == "--memory") {
+            options.memory = true;
+        } else if (arg == "--min-size") {
+            options.minSize = std::max<std::size_t>(1, parseCount(value));
+        } else if (arg == "--max-size") {
+            options.maxSize = parseCount(value);
+        } else if (arg == "--backends") {
+            options.backends = splitList(value);
+        } else if (arg == "--keys") {
+            options.keyTypes = splitList(value);
+        } else if (arg == "--queries") {
+            options.queries = parseCount(value);
+        } else if (arg == "--range-width") {
+            options.rangeWidth = std::max<std::size_t>(1, parseCount(value));
+            options.workloadConfig.rangeWidth = options.rangeWidth;
+        } else if (arg == "--batch") {
+            options.batch = std::max<std::size_t>(1, parseCount(value));
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(value);
+            options.workloadConfig.seed = options.seed;
+        } else if (arg == "--workload") {
+            options.workloadConfig.distribution = parseDistribution(value);
+            options.workload = value;
+        } else if (arg == "--ops") {
+            options.workloadOps = parseCount(value);
+        } else if (arg == "--key-space") {
+            options.workloadConfig.keySpace = parseCount(value);
+        } else if (arg == "--preload") {
+            options.workloadConfig.preload = parseCount(value);
+        } else if (arg == "--zipf-skew") {
+            options.workloadConfig.zipfSkew = std::stod(value);
+        } else if (arg == "--window") {
+            options.workloadConfig.windowSize = std::max<std::size_t>(1, parseCount(value));
+        } else if (arg == "--mix") {
+            const std::vector<std::string> weights = splitList(value);
+            if (weights.size() != 4) throw std::invalid_argument("--mix needs four weights");
+            options.workloadConfig.insertWeight = std::stoul(weights[0]);
+            options.workloadConfig.removeWeight = std::stoul(weights[1]);
+            options.workloadConfig.lookupWeight = std::stoul(weights[2]);
+            options.workloadConfig.rangeWeight = std::stoul(weights[3]);
+        } else if (arg == "--threads") {
+            options.threads = parseCount(value);
+            if (options.threads == 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+        } else if (arg == "--read-percent") {
+            options.readPercent = std::min<unsigned>(100, std::stoul(value));
+        } else if (arg == "--concurrent") {
+            options.concurrent = splitList(value);
+        } else if (arg == "--trace") {
+            options.tracePath = value;
+        } else if (arg == "--format") {
+            if (value == "csv") options.format = Reporter::Format::Csv;
+            else if (value == "json") options.format = Reporter::Format::Json;
+            else throw std::invalid_argument("unknown format " + value);
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    return options;
+}
+
+int main(const int argc, char** argv) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        printUsage(std::cerr);
+        return 1;
+    }
+
+    Reporter reporter(options.format);
+
+    std::unique_ptr<PerfCounters> counters;
+    if (options.perf) {
+        if (options.threads) {
+            std::cerr << "--perf cannot be combined with --threads" << std::endl;
+            return 1;
+        }
+        counters = std::make_unique<PerfCounters>();
+        if (!counters->available()) {
+            std::cerr << "perf counters unavailable (check /proc/sys/kernel/perf_event_paranoid), columns stay empty"
+                      << std::endl;
+        }
+    }
+    PerfCounters* perf = counters.get();
+
+    if (options.memory) {
+        if (!options.workload.empty()) {
+            std::cerr << "--memory cannot be combined with --workload" << std::endl;
+            return 1;
+        }
+        if (!allocationCountingSupported()) {
+            std::cerr << "allocation counting needs glibc, heap columns will read 0" << std::endl;
+        }
+        enableAllocationCounting();
+    }
+
+    for (const std::string& keyType : options.keyTypes) {
+        if (keyType == "int") {
+            if (options.threads) runScalabilityKeyType<int>(keyType, options, reporter);
+            else if (options.workload.empty()) runKeyType<int>(keyType, options, reporter, perf);
+            else runWorkloadKeyType<int>(keyType, options, reporter, perf);
+        } else if (keyType == "string") {
+            if (options.threads) runScalabilityKeyType<std::string>(keyType, options, reporter);
+            else if (options.workload.empty()) runKeyType<std::string>(keyType, options, reporter, perf);
+            else runWorkloadKeyType<std::string>(keyType, options, reporter, perf);
+        } else {
+            std::cerr << "unknown key type " << keyType << std::endl;
+            return 1;
+        }
+    }
+    reporter.finish();
+
+    if (!options.tracePath.empty()) {
+#ifdef AVL_TREE_TRACING
+        std::ofstream trace(options.tracePath);
+        AVLTraceRegistry::instance().writeChromeTrace(trace);
+#else
+        std::cerr << "built without AVL_TREE_TRACING, no trace written" << std::endl;
+#endif
+    }
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+#ifndef CONCURRENTBACKENDS_H
+#define CONCURRENTBACKENDS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+#include "AVLTree.h"
+
+// Thread-safe AVLTree variants for the scalability benchmark. They expose insert, remove and
+// contains and may be called from any number of threads.
+
+template <typename T>
+class MutexAVLTree {
+    AVLTree<T> tree;
+    mutable std::mutex mutex;
+
+public:
+    static constexpr std::string_view name = "AVLTree+mutex";
+
+    void insert(const T& value) {
+        std::lock_guard lock(mutex);
+        tree.insert(value);
+    }
+
+    void remove(const T& value) {
+        std::lock_guard lock(mutex);
+        tree.remove(value);
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        std::lock_guard lock(mutex);
+        return tree.contains(value);
+    }
+};
+
+// Readers share the lock, so lookups scale until writers show up. With AVL_TREE_STATS every
+// lookup also adds to the tree's counters with a relaxed atomic, which readers contend on.
+template <typename T>
+class SharedMutexAVLTree {
+    AVLTree<T> tree;
+    mutable std::shared_mutex mutex;
+
+public:
+    static constexpr std::string_view name = "AVLTree+shared_mutex";
+
+    void insert(const T& value) {
+        std::unique_lock lock(mutex);
+        tree.insert(value);
+    }
+
+    void remove(const T& value) {
+        std::unique_lock lock(mutex);
+        tree.remove(value);
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+#ifdef AVL_TREE_STATS
+        std::unique_lock lock(mutex);
+#else
+        std::shared_lock lock(mutex);
+#endif
+        return tree.contains(value);
+    }
+};
+
+// Keys are spread over independent mutex-protected trees by hash. Point operations only lock
+// one shard; ordered traversal across shards would need a merge and is not offered.
+template <typename T, std::size_t Shards = 64>
+class ShardedAVLTree {
+    struct alignas(64) Shard {
+        AVLTree<T> tree;
+        mutable std::mutex mutex;
+    };
+
+    std::array<Shard, Shards> shards;
+
+    [[nodiscard]] Shard& shardFor(const T& value) { return shards[std::hash<T>{}(value) % Shards]; }
+    [[nodiscard]] const Shard& shardFor(const T& value) const { return shards[std::hash<T>{}(value) % Shards]; }
+
+public:
+    static constexpr std::string_view name = "AVLTree+sharded";
+
+    void insert(const T& value) {
+        Shard& shard = shardFor(value);
+        std::lock_guard lock(shard.mutex);
+        shard.tree.insert(value);
+    }
+
+    void remove(const T& value) {
+        Shard& shard = shardFor(value);
+        std::lock_guard lock(shard.mutex);
+        shard.tree.remove(value);
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        const Shard& shard = shardFor(value);
+        std::lock_guard lock(shard.mutex);
+        return shard.tree.contains(value);
+    }
+};
+
+// Readers load the current immutable snapshot and search it without taking a lock. Writers
+// serialise on a mutex, apply the write to their own tree and publish a copy of it (AVLTree's
+// O(n) structural copy) after every PublishEvery writes. Lookups may therefore miss up to
+// PublishEvery - 1 recent writes, and every publish costs a full copy of the tree. Readers are
+// lock-free but not contention-free under AVL_TREE_STATS: each lookup adds to the snapshot's
+// counters with a relaxed atomic.
+template <typename T, std::size_t PublishEvery = 1>
+class SnapshotAVLTree {
+    AVLTree<T> master;
+    std::size_t unpublished = 0;
+    std::mutex writeMutex;
+    std::atomic<std::shared_ptr<const AVLTree<T>>> snapshot{std::make_shared<const AVLTree<T>>()};
+
+    void publish() {
+        unpublished = 0;
+        snapshot.store(std::make_shared<const AVLTree<T>>(master), std::memory_order_release);
+    }
+
+    void written() {
+        if (++unpublished >= PublishEvery) publish();
+    }
+
+public:
+    static constexpr std::string_view name = "AVLTree+snapshot";
+
+    // Inserts all values and publishes once, instead of once per PublishEvery values.
+    void preload(const std::vector<T>& values) {
+        std::lock_guard lock(writeMutex);
+        for (const T& value : values) master.insert(value);
+        publish();
+    }
+
+    void insert(const T& value) {
+        std::lock_guard lock(writeMutex);
+        master.insert(value);
+        written();
+    }
+
+    void remove(const T& value) {
+        std::lock_guard lock(writeMutex);
+        master.remove(value);
+        written();
+    }
+
+    [[nodiscard]] bool contains(const T& value) const {
+        return snapshot.load(std::memory_order_acquire)->contains(value);
+    }
+};
+
+#endif //CONCURRENTBACKENDS_H
@@ -0,0 +1,140 @@
+#ifndef HARNESS_H
+#define HARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+template <typename V>
+inline void doNotOptimize(const V& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Measurement {
+    std::size_t ops = 0;
+    double nsPerOp = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double max = 0;
+};
+
+struct Result {
+    std::string backend;
+    std::string keyType;
+    std::string operation;
+    std::size_t size = 0;
+    Measurement measurement;
+    // Optional per-operation columns such as hardware counters; every result of one run has to
+    // carry the same names in the same order. Missing values print as empty / null.
+    std::vector<std::pair<std::string, std::optional<double>>> extra = {};
+};
+
+[[nodiscard]] inline double percentile(const std::vector<double>& sorted, const double p) {
+    if (sorted.empty()) return 0;
+    const auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// start() runs right before the first timed batch of measure() and stop() right after the
+// last, so what a region records, e.g. hardware counters, covers the operations and the batch
+// clock reads but not the bookkeeping around them.
+struct NoRegion {
+    void start() {}
+    void stop() {}
+};
+
+// Timing every single operation would mostly measure the clock, so ops run in batches and each
+// batch contributes one ns/op sample. The percentiles are therefore over batch averages.
+template <typename Op, typename Region = NoRegion>
+Measurement measure(const std::size_t ops, const std::size_t batchSize, Op&& op, Region&& region = {}) {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<double> samples;
+    samples.reserve(ops / std::max<std::size_t>(batchSize, 1) + 1);
+
+    std::chrono::nanoseconds total{0};
+    region.start();
+    for (std::size_t begin = 0; begin < ops; begin += batchSize) {
+        const std::size_t end = std::min(ops, begin + batchSize);
+        const auto start = Clock::now();
+        for (std::size_t i = begin; i < end; ++i) {
+            op(i);
+        }
+        const auto elapsed = Clock::now() - start;
+        total += elapsed;
+        samples.push_back(static_cast<double>(elapsed.count()) / static_cast<double>(end - begin));
+    }
+    region.stop();
+
+    std::sort(samples.begin(), samples.end());
+
+    Measurement m;
+    m.ops = ops;
+    m.nsPerOp = ops ? static_cast<double>(total.count()) / static_cast<double>(ops) : 0;
+    m.p50 = percentile(samples, 0.50);
+    m.p90 = percentile(samples, 0.90);
+    m.p99 = percentile(samples, 0.99);
+    m.p999 = percentile(samples, 0.999);
+    m.max = samples.empty() ? 0 : samples.back();
+    return m;
+}
+
+class Reporter {
+public:
+    enum class Format { Csv, Json };
+
+    explicit Reporter(const Format format, std::ostream& os = std::cout) : format(format), os(os) {}
+
+    void add(const Result& result) {
+        const Measurement& m = result.measurement;
+        if (format == Format::Csv) {
+            if (first) {
+                os << "backend,key_type,operation,size,ops,ns_per_op,p50,p90,p99,p999,max";
+                for (const auto& [name, value] : result.extra) os << ',' << name;
+                os << std::endl;
+            }
+            os << result.backend << ',' << result.keyType << ',' << result.operation << ','
+               << result.size << ',' << m.ops << ',' << m.nsPerOp << ',' << m.p50 << ',' << m.p90 << ','
+               << m.p99 << ',' << m.p999 << ',' << m.max;
+            for (const auto& [name, value] : result.extra) {
+                os << ',';
+                if (value) os << *value;
+            }
+            os << std::endl;
+        } else {
+            os << (first ? "[\n" : ",\n")
+               << "  {\"backend\": \"" << result.backend << "\", \"key_type\": \"" << result.keyType
+               << "\", \"operation\": \"" << result.operation << "\", \"size\": " << result.size
+               << ", \"ops\": " << m.ops << ", \"ns_per_op\": " << m.nsPerOp << ", \"p50\": " << m.p50
+               << ", \"p90\": " << m.p90 << ", \"p99\": " << m.p99 << ", \"p999\": " << m.p999
+               << ", \"max\": " << m.max;
+            for (const auto& [name, value] : result.extra) {
+                os << ", \"" << name << "\": ";
+                if (value) os << *value;
+                else os << "null";
+            }
+            os << "}";
+        }
+        first = false;
+    }
+
+    void finish() {
+        if (format == Format::Json) {
+            os << (first ? "[]" : "\n]") << std::endl;
+        }
+    }
+
+private:
+    Format format;
+    std::ostream& os;
+    bool first = true;
+};
+
+#endif //HARNESS_H
@@ -0,0 +1,34 @@
+#ifndef KEYS_H
+#define KEYS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+[[nodiscard]] inline std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Benchmarks talk about keys as ordinals; makeKey turns an ordinal into the key type under test
+// while keeping the ordinal order, so range bounds mean the same thing for every key type.
+template <typename T>
+T makeKey(std::uint64_t n);
+
+template <>
+inline int makeKey<int>(const std::uint64_t n) {
+    return static_cast<int>(n);
+}
+
+// 20 characters is past the small-string buffer, so every key owns a heap allocation like
+// real identifiers do.
+template <>
+inline std::string makeKey<std::string>(const std::uint64_t n) {
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "key:%016llx", static_cast<unsigned long long>(n));
+    return buffer;
+}
+
+#endif //KEYS_H
@@ -0,0 +1,105 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters around a measured region through perf_event_open. Every event is opened
+// on its own so a PMU that cannot count one of them still delivers the rest; when the kernel
+// multiplexes, values are scaled by enabled/running time. Events that fail to open (no
+// permission, virtual machine, non-Linux) read as std::nullopt.
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, L1DMisses, LLCMisses, BranchMisses, DTLBMisses, EventCount };
+
+    static constexpr std::array<std::string_view, EventCount> names{
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"};
+
+    using Sample = std::array<std::optional<double>, EventCount>;
+
+    PerfCounters() {
+#ifdef __linux__
+        constexpr auto cache = [](const std::uint64_t id) {
+            return id | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        const std::array<std::pair<std::uint32_t, std::uint64_t>, EventCount> configs{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_L1D)},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_LL)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_DTLB)},
+        }};
+
+        for (int i = 0; i < EventCount; ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = configs[i].first;
+            attr.config = configs[i].second;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (const int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    [[nodiscard]] bool available() const {
+        for (const int fd : fds) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    void start() {
+#ifdef __linux__
+        for (const int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    [[nodiscard]] Sample stop() {
+        Sample sample{};
+#ifdef __linux__
+        for (int i = 0; i < EventCount; ++i) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+            std::uint64_t values[3]{};
+            if (read(fds[i], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[2] == 0) continue;
+            sample[i] = static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+        }
+#endif
+        return sample;
+    }
+
+private:
+    std::array<int, EventCount> fds{-1, -1, -1, -1, -1, -1};
+};
+
+#endif //PERFCOUNTERS_H
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Backends.h"
+#include "Harness.h"
+#include "OperationTrace.h"
+#include "Workload.h"
+
+struct ReplayOptions {
+    std::string tracePath;
+    std::vector<std::string> backends = backendKeys();
+    std::size_t batch = 64;
+    Reporter::Format format = Reporter::Format::Csv;
+};
+
+// contains and get both become lookups, the baselines have no get and the difference is
+// only the copy of the found value.
+template <typename T>
+std::vector<TypedOperation<T>> loadTrace(TraceReader& reader) {
+    std::vector<TypedOperation<T>> ops;
+    TraceOp op;
+    T key;
+    while (reader.next(op, key)) {
+        const OpType type = op == TraceOp::Insert ? OpType::Insert
+                            : op == TraceOp::Remove ? OpType::Remove
+                            : OpType::Lookup;
+        ops.push_back({type, key, T{}});
+    }
+    return ops;
+}
+
+// Backends are capped by the peak number of keys the trace can hold, which is at most its
+// insert count.
+template <typename Backend, typename T>
+void replay(const std::vector<TypedOperation<T>>& ops, const std::string& keyType, const ReplayOptions& options,
+            Reporter& reporter) {
+    const auto inserts = static_cast<std::size_t>(std::count_if(ops.begin(), ops.end(), [](const auto& op) {
+        return op.type == OpType::Insert;
+    }));
+    if (inserts > Backend::maxSize) {
+        std::cerr << "skipping " << Backend::name << " (" << inserts << " inserts, limit " << Backend::maxSize << ")"
+                  << std::endl;
+        return;
+    }
+
+    Backend backend;
+    std::size_t sink = 0;
+    const Measurement m = measure(ops.size(), options.batch, [&](const std::size_t i) {
+        apply(backend, ops[i], sink);
+    });
+    doNotOptimize(sink);
+
+    reporter.add(Result{std::string(Backend::name), keyType, "replay", ops.size(), m});
+}
+
+template <typename T>
+void replayAll(TraceReader& reader, const std::string& keyType, const ReplayOptions& options, Reporter& reporter) {
+    const std::vector<TypedOperation<T>> ops = loadTrace<T>(reader);
+    auto selected = [&options](const std::string_view name) {
+        return std::find(options.backends.begin(), options.backends.end(), name) != options.backends.end();
+    };
+
+    forEachRegisteredBackend<T>([&]<typename Backend>(const std::string_view key) {
+        if (selected(key)) replay<Backend>(ops, keyType, options, reporter);
+    });
+}
+
+void printUsage(std::ostream& os) {
+    os << "Usage: AuD_Praktikum_1_replay TRACE [options]\n"
+          "  --backends LIST    comma separated: " << backendKeyList() << "\n"
+          "  --batch N          operations per timing sample (default 64)\n"
+          "  --format csv|json  output format (default csv)\n";
+}
+
+ReplayOptions parseOptions(const int argc, char** argv) {
+    ReplayOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help") {
+            printUsage(std::cout);
+            std::exit(0);
+        }
+        if (arg.rfind("--", 0) != 0) {
+            options.tracePath = arg;
+            continue;
+        }
+        if (i + 1 >= argc) throw std::invalid_argument("missing value for " + arg);
+        const std::string value = argv[++i];
+
+        if (arg == "--backends") {
+            options.backends = splitList(value);
+        } else if (arg == "--batch") {
+            options.batch = std::max<std::size_t>(1, parseCount(value));
+        } else if (arg == "--format") {
+            if (value == "csv") options.format = Reporter::Format::Csv;
+            else if (value == "json") options.format = Reporter::Format::Json;
+            else throw std::invalid_argument("unknown format " + value);
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    if (options.tracePath.empty()) throw std::invalid_argument("no trace file given");
+    return options;
+}
+
+int main(const int argc, char** argv) {
+    try {
+        const ReplayOptions options = parseOptions(argc, argv);
+        TraceReader reader(options.tracePath);
+        Reporter reporter(options.format);
+
+        if (reader.kind() == TraceKeyKind::Integer) {
+            replayAll<std::int64_t>(reader, "int", options, reporter);
+        } else {
+            replayAll<std::string>(reader, "string", options, reporter);
+        }
+        reporter.finish();
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        printUsage(std::cerr);
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+#ifndef SCALABILITY_H
+#define SCALABILITY_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Harness.h"
+#include "LatencyHistogram.h"
+#include "Workload.h"
+
+struct ScalabilityConfig {
+    std::size_t maxThreads = 1;
+    std::size_t opsPerThread = 200'000;
+    std::uint64_t keySpace = 1'000'000;
+    unsigned readPercent = 90;
+    std::uint64_t seed = 42;
+    // Only every Nth operation of a thread reads the clock for the latency histogram.
+    std::size_t sampleEvery = 16;
+};
+
+// 1, 2, 4, ... and always maxThreads itself, so odd core counts are measured too.
+[[nodiscard]] inline std::vector<std::size_t> threadCounts(const std::size_t maxThreads) {
+    std::vector<std::size_t> counts;
+    for (std::size_t t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(std::max<std::size_t>(1, maxThreads));
+    return counts;
+}
+
+// Jain's fairness index over per-thread throughput: 1 when every thread got the same share,
+// 1/threads when one thread did all the work.
+[[nodiscard]] inline double jainFairness(const std::vector<double>& throughput) {
+    double sum = 0;
+    double squares = 0;
+    for (const double x : throughput) {
+        sum += x;
+        squares += x * x;
+    }
+    return squares > 0 ? sum * sum / (static_cast<double>(throughput.size()) * squares) : 0;
+}
+
+// Every thread replays its own uniform stream (writes split evenly between insert and remove)
+// against one shared tree that starts half full. All threads are released at once and the
+// wall time runs until the last one finishes.
+template <typename Tree, typename T>
+Result runScalability(const std::size_t threads, const ScalabilityConfig& config, const std::string& keyType) {
+    using Clock = std::chrono::steady_clock;
+
+    const unsigned writePercent = 100 - std::min(config.readPercent, 100u);
+    std::vector<std::vector<TypedOperation<T>>> streams;
+    std::vector<T> preload;
+    for (std::size_t t = 0; t < threads; ++t) {
+        WorkloadConfig workload;
+        workload.seed = config.seed + t;
+        workload.keySpace = config.keySpace;
+        workload.preload = t == 0 ? config.keySpace / 2 : 0;
+        workload.insertWeight = (writePercent + 1) / 2;
+        workload.removeWeight = writePercent / 2;
+        workload.lookupWeight = 100 - writePercent;
+        workload.rangeWeight = 0;
+
+        WorkloadGenerator generator(workload);
+        for (const std::uint64_t key : generator.preload()) preload.push_back(makeKey<T>(key));
+        streams.push_back(materialize<T>(generator.generate(config.opsPerThread)));
+    }
+
+    Tree tree;
+    if constexpr (requires { tree.preload(preload); }) {
+        tree.preload(preload);
+    } else {
+        for (const T& key : preload) tree.insert(key);
+    }
+
+    std::vector<LatencyHistogram> histograms(threads);
+    std::vector<Clock::duration> elapsed(threads);
+    std::atomic<std::size_t> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<std::size_t> sink{0};
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            const std::vector<TypedOperation<T>>& ops = streams[t];
+            LatencyHistogram& histogram = histograms[t];
+            std::size_t hits = 0;
+
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {}
+
+            const auto start = Clock::now();
+            for (std::size_t i = 0; i < ops.size(); ++i) {
+                const bool sampled = i % config.sampleEvery == 0;
+                const auto opStart = sampled ? Clock::now() : Clock::time_point{};
+                switch (ops[i].type) {
+                    case OpType::Insert: tree.insert(ops[i].key); break;
+                    case OpType::Remove: tree.remove(ops[i].key); break;
+                    default: hits += tree.contains(ops[i].key); break;
+                }
+                if (sampled) {
+                    histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - opStart).count());
+                }
+            }
+            elapsed[t] = Clock::now() - start;
+            sink.fetch_add(hits, std::memory_order_relaxed);
+        });
+    }
+
+    while (ready.load() < threads) {}
+    const auto wallStart = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) worker.join();
+    const double wallNs = std::chrono::duration<double, std::nano>(Clock::now() - wallStart).count();
+    doNotOptimize(sink.load());
+
+    LatencyHistogram merged;
+    std::vector<double> perThread;
+    for (std::size_t t = 0; t < threads; ++t) {
+        merged.merge(histograms[t]);
+        perThread.push_back(static_cast<double>(streams[t].size()) /
+                            std::chrono::duration<double>(elapsed[t]).count());
+    }
+
+    const std::size_t totalOps = threads * config.opsPerThread;
+    Measurement m;
+    m.ops = totalOps;
+    m.nsPerOp = wallNs / static_cast<double>(std::max<std::size_t>(totalOps, 1));
+    m.p50 = static_cast<double>(merged.percentile(0.50));
+    m.p90 = static_cast<double>(merged.percentile(0.90));
+    m.p99 = static_cast<double>(merged.percentile(0.99));
+    m.p999 = static_cast<double>(merged.percentile(0.999));
+    m.max = static_cast<double>(merged.max());
+
+    Result result{std::string(Tree::name), keyType, "threads", config.keySpace, m};
+    result.extra = {
+        {"threads", static_cast<double>(threads)},
+        {"read_percent", static_cast<double>(100 - writePercent)},
+        {"mops_per_s", static_cast<double>(totalOps) / wallNs * 1e3},
+        {"fairness", jainFairness(perThread)},
+    };
+    return result;
+}
+
+#endif //SCALABILITY_H
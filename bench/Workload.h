@@ -0,0 +1,264 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Keys.h"
+
+enum class Distribution { Uniform, Zipf, Sequential, SlidingWindow };
+
+enum class OpType : std::uint8_t { Insert, Remove, Lookup, Range };
+
+struct Operation {
+    OpType type;
+    std::uint64_t key;
+    std::uint64_t high; // only meaningful for Range
+};
+
+template <typename T>
+struct TypedOperation {
+    OpType type;
+    T key;
+    T high;
+};
+
+struct WorkloadConfig {
+    Distribution distribution = Distribution::Uniform;
+    std::uint64_t seed = 42;
+    std::uint64_t keySpace = 1'000'000;
+    std::size_t preload = 100'000;
+    double zipfSkew = 0.99;
+    std::size_t windowSize = 100'000;
+    std::uint64_t rangeWidth = 100;
+    // Relative weights, they do not have to add up to 100.
+    unsigned insertWeight = 10;
+    unsigned removeWeight = 10;
+    unsigned lookupWeight = 75;
+    unsigned rangeWeight = 5;
+};
+
+[[nodiscard]] inline Distribution parseDistribution(const std::string& name) {
+    if (name == "uniform") return Distribution::Uniform;
+    if (name == "zipf") return Distribution::Zipf;
+    if (name == "sequential") return Distribution::Sequential;
+    if (name == "window") return Distribution::SlidingWindow;
+    throw std::invalid_argument("unknown distribution " + name);
+}
+
+[[nodiscard]] inline const char* distributionName(const Distribution distribution) {
+    switch (distribution) {
+        case Distribution::Uniform: return "uniform";
+        case Distribution::Zipf: return "zipf";
+        case Distribution::Sequential: return "sequential";
+        case Distribution::SlidingWindow: return "window";
+    }
+    return "unknown";
+}
+
+// Rejection-inversion sampling (Hoermann and Derflinger) draws Zipf ranks in O(1) without a
+// table over the key space, which matters once the key space reaches 1e8.
+class ZipfSampler {
+    double exponent;
+    double n;
+    double hIntegralX1;
+    double hIntegralN;
+    double s;
+
+    [[nodiscard]] static double helper1(const double x) {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+    }
+
+    [[nodiscard]] static double helper2(const double x) {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x * (1.0 / 3) * (1 + 0.25 * x));
+    }
+
+    [[nodiscard]] double h(const double x) const {
+        return std::exp(-exponent * std::log(x));
+    }
+
+    [[nodiscard]] double hIntegral(const double x) const {
+        const double logX = std::log(x);
+        return helper2((1 - exponent) * logX) * logX;
+    }
+
+    [[nodiscard]] double hIntegralInverse(const double x) const {
+        const double t = std::max(-1.0, x * (1 - exponent));
+        return std::exp(helper1(t) * x);
+    }
+
+public:
+    ZipfSampler(const std::uint64_t elements, const double exponent)
+        : exponent(exponent), n(static_cast<double>(elements)) {
+        if (elements == 0 || exponent <= 0) throw std::invalid_argument("zipf needs elements and a positive skew");
+        hIntegralX1 = hIntegral(1.5) - 1;
+        hIntegralN = hIntegral(n + 0.5);
+        s = 2 - hIntegralInverse(hIntegral(2.5) - h(2));
+    }
+
+    // Returns a rank in [1, elements], rank 1 being the most frequent.
+    template <typename Rng>
+    std::uint64_t operator()(Rng& rng) {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        while (true) {
+            const double u = hIntegralN + uniform(rng) * (hIntegralX1 - hIntegralN);
+            const double x = hIntegralInverse(u);
+            const double k = std::clamp(std::floor(x + 0.5), 1.0, n);
+            if (k - x <= s || u >= hIntegral(k + 0.5) - h(k)) {
+                return static_cast<std::uint64_t>(k);
+            }
+        }
+    }
+};
+
+// Produces the same operation stream for a given config and seed, independent of the
+// container it is replayed against.
+class WorkloadGenerator {
+    WorkloadConfig config;
+    std::mt19937_64 rng;
+    std::uniform_int_distribution<std::uint64_t> uniformKey;
+    ZipfSampler zipf;
+    std::discrete_distribution<int> mix;
+    std::uint64_t multiplier = 1;
+    std::uint64_t offset = 0;
+    std::uint64_t next = 0;
+    std::deque<std::uint64_t> window;
+    std::vector<Operation> pending;
+
+    // Spreads the hot Zipf ranks over the key space with an affine permutation, otherwise the
+    // hottest keys would all be neighbours and share one root-to-leaf path.
+    [[nodiscard]] std::uint64_t scatter(const std::uint64_t rank) const {
+        const auto product = static_cast<unsigned __int128>(rank) * multiplier + offset;
+        return static_cast<std::uint64_t>(product % config.keySpace);
+    }
+
+    [[nodiscard]] std::uint64_t recentKey() {
+        if (next == 0) return 0;
+        const std::uint64_t oldest = config.distribution == Distribution::SlidingWindow && !window.empty()
+                                         ? window.front()
+                                         : 0;
+        return std::uniform_int_distribution<std::uint64_t>(oldest, next - 1)(rng);
+    }
+
+    [[nodiscard]] std::uint64_t drawKey() {
+        switch (config.distribution) {
+            case Distribution::Uniform: return uniformKey(rng);
+            case Distribution::Zipf: return scatter(zipf(rng) - 1);
+            case Distribution::Sequential:
+            case Distribution::SlidingWindow: return recentKey();
+        }
+        return 0;
+    }
+
+    [[nodiscard]] Operation appendKey() {
+        const std::uint64_t key = next++;
+        if (config.distribution == Distribution::SlidingWindow) {
+            window.push_back(key);
+            if (window.size() > config.windowSize) {
+                pending.push_back({OpType::Remove, window.front(), 0});
+                window.pop_front();
+            }
+        }
+        return {OpType::Insert, key, 0};
+    }
+
+public:
+    explicit WorkloadGenerator(const WorkloadConfig& cfg)
+        : config(cfg),
+          rng(cfg.seed),
+          uniformKey(0, std::max<std::uint64_t>(cfg.keySpace, 1) - 1),
+          zipf(std::max<std::uint64_t>(cfg.keySpace, 1), cfg.zipfSkew),
+          mix{static_cast<double>(cfg.insertWeight), static_cast<double>(cfg.removeWeight),
+              static_cast<double>(cfg.lookupWeight), static_cast<double>(cfg.rangeWeight)} {
+        if (config.keySpace == 0) throw std::invalid_argument("key space must not be empty");
+        if (config.insertWeight + config.removeWeight + config.lookupWeight + config.rangeWeight == 0) {
+            throw std::invalid_argument("operation mix must not be empty");
+        }
+        multiplier = static_cast<std::uint64_t>(static_cast<double>(config.keySpace) * 0.6180339887) | 1;
+        while (std::gcd(multiplier, config.keySpace) != 1) multiplier += 2;
+        offset = splitmix64(config.seed) % config.keySpace;
+    }
+
+    // Keys the container holds before the measured stream starts. The monotonic distributions
+    // continue counting from where the preload stopped, and a window preload never exceeds the
+    // window.
+    [[nodiscard]] std::vector<std::uint64_t> preload() {
+        const bool monotonic = config.distribution == Distribution::Sequential ||
+                               config.distribution == Distribution::SlidingWindow;
+        const std::size_t count = config.distribution == Distribution::SlidingWindow
+                                      ? std::min(config.preload, config.windowSize)
+                                      : config.preload;
+
+        std::vector<std::uint64_t> keys;
+        keys.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            keys.push_back(monotonic ? appendKey().key : drawKey());
+        }
+        return keys;
+    }
+
+    // Sliding windows turn an insert past the window size into the insert followed by the
+    // removal of the oldest key; the configured remove weight is not used there.
+    [[nodiscard]] Operation operator()() {
+        if (!pending.empty()) {
+            const Operation op = pending.back();
+            pending.pop_back();
+            return op;
+        }
+
+        auto type = static_cast<OpType>(mix(rng));
+        if (config.distribution == Distribution::SlidingWindow && type == OpType::Remove) {
+            type = OpType::Insert;
+        }
+
+        if (type == OpType::Insert && config.distribution != Distribution::Uniform &&
+            config.distribution != Distribution::Zipf) {
+            return appendKey();
+        }
+
+        const std::uint64_t key = drawKey();
+        if (type == OpType::Range) {
+            return {type, key, key + config.rangeWidth - 1};
+        }
+        return {type, key, 0};
+    }
+
+    [[nodiscard]] std::vector<Operation> generate(const std::size_t count) {
+        std::vector<Operation> ops;
+        ops.reserve(count);
+        while (ops.size() < count) {
+            ops.push_back((*this)());
+        }
+        return ops;
+    }
+};
+
+// Converting keys up front keeps string formatting out of the timed loop.
+template <typename T>
+[[nodiscard]] std::vector<TypedOperation<T>> materialize(const std::vector<Operation>& ops) {
+    std::vector<TypedOperation<T>> typed;
+    typed.reserve(ops.size());
+    for (const Operation& op : ops) {
+        typed.push_back({op.type, makeKey<T>(op.key), op.type == OpType::Range ? makeKey<T>(op.high) : T{}});
+    }
+    return typed;
+}
+
+template <typename T, typename Backend>
+void apply(Backend& backend, const TypedOperation<T>& op, std::size_t& sink) {
+    switch (op.type) {
+        case OpType::Insert: backend.insert(op.key); break;
+        case OpType::Remove: backend.remove(op.key); break;
+        case OpType::Lookup: sink += backend.contains(op.key); break;
+        case OpType::Range: backend.range(op.key, op.high, [&sink](const auto&) { ++sink; }); break;
+    }
+}
+
+#endif //WORKLOAD_H
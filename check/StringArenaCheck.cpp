@@ -0,0 +1,59 @@
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "StringArenaAVLTree.h"
+
+// Checks that StringArenaAVLTree::compact() shrinks the arena and that a rolled-back duplicate
+// leaves no chunk behind. Exits non-zero on the first failure.
+
+namespace {
+
+bool check(const bool ok, const char* what) {
+    if (!ok) std::cerr << "FAILED: " << what << std::endl;
+    return ok;
+}
+
+// 10k keys of 22 bytes fill four 64 KiB chunks with stranded tails; the compacted arena holds
+// them in one chunk of their exact size.
+bool compactShrinksArena() {
+    StringArenaAVLTree words;
+    char key[32];
+    for (int i = 0; i < 10000; ++i) {
+        std::snprintf(key, sizeof key, "key-%018d", i);
+        words.insert(key);
+    }
+    const std::size_t full = words.arenaBytes();
+    words.compact();
+    const std::size_t compacted = words.arenaBytes();
+    if (!check(compacted < full, "compact() shrinks a full arena")) return false;
+
+    for (int i = 0; i < 10000; i += 2) {
+        std::snprintf(key, sizeof key, "key-%018d", i);
+        words.remove(key);
+    }
+    words.compact();
+    return check(words.arenaBytes() < compacted, "compact() reclaims removed keys") &&
+           check(words.garbageBytes() == 0, "compact() leaves no garbage");
+}
+
+bool duplicateRollsBackChunk() {
+    StringArenaAVLTree words;
+    words.insert(std::string(30000, 'a'));
+    words.insert(std::string(30000, 'b'));
+    const std::size_t before = words.arenaBytes();
+    words.insert(std::string(30000, 'b'));
+    if (!check(words.arenaBytes() == before, "a rolled-back duplicate frees the chunk it opened")) return false;
+
+    words.insert(std::string(3000, 'c'));
+    return check(words.arenaBytes() == before, "appends continue in the previous chunk after a rollback");
+}
+
+} // namespace
+
+int main() {
+    const bool ok = compactShrinksArena() && duplicateRollsBackChunk();
+    if (ok) std::cout << "StringArena checks passed" << std::endl;
+    return ok ? 0 : 1;
+}